@@ -32,7 +32,7 @@ defineTest(qtVer) {
     }
     return(false)
 }
-!qtVer(4,6,0): error(This application requires at least Qt version 4.6.0)
+!qtVer(4,7,0): error(This application requires at least Qt version 4.7.0)
 
 #####################
 # QMAKE INFORMATION #
@@ -22,4 +22,6 @@ TEMPLATE = subdirs
 CONFIG  += ordered
 SUBDIRS  = plugins
 
+benchmarks: SUBDIRS += benchmarks
+
 OTHER_FILES += Doxyfile fileheader.txt
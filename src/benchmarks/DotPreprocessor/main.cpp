@@ -0,0 +1,262 @@
+/*!
+   \file main.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include <QtCore>
+
+#include <SWAT/DirectedGraph/DotPreprocessor.h>
+
+using namespace Plugins::DirectedGraph;
+
+/*! \brief Compares the DOT label preprocessing against the per-line regular expressions it replaced
+
+    Usage: DotPreprocessorBenchmark [frames=100000] [ranks=65536] [repetitions=3]
+
+    Builds a synthetic STAT call graph with the given number of frames, spread over the given number of ranks, and
+    runs the old preprocessor, and the new one with its labels decoded serially and across the thread pool.  The
+    labels are decoded as STATScene does.  The outputs are checked against each other, and every run is printed as
+    a CSV row: implementation,repetition,bytes,milliseconds,megabytesPerSecond
+ */
+
+static const int maxNodeLabelSize = 64;
+static const int maxEdgeLabelSize = 24;
+
+//! Short node label, decoded the way STATScene does
+static QString shortNodeLabel(const QString &label)
+{
+    QRegExp rxFullText("^([\\d\\w\\_\\-\\.]+)(?:@([\\d\\w\\_\\-\\.\\/\\\\]+)(?:\\:(\\d+))?)?(?:\\$(.+))?");
+
+    QString longLabel = label.trimmed();
+    if(rxFullText.indexIn(longLabel) >= 0) {
+        longLabel = rxFullText.cap(1);
+        if(!rxFullText.cap(3).isEmpty()) {
+            longLabel += QString("@%1:%2").arg(QFileInfo(rxFullText.cap(2)).fileName()).arg(rxFullText.cap(3).toULong());
+        }
+    }
+
+    return (longLabel.count() > maxNodeLabelSize) ? "..." + longLabel.right(maxNodeLabelSize - 3) : longLabel;
+}
+
+//! Short edge label, decoded the way STATScene does; the process list is read and counted
+static QString shortEdgeLabel(const QString &label)
+{
+    QRegExp rxLabel("(?:(\\d+):)*\\[(.*)\\]");
+    QRegExp rxRange("(\\d+)\\-(\\d+)");
+
+    QStringList processList;
+    if(rxLabel.indexIn(label) >= 0) {
+        processList = rxLabel.cap(2).split(',');
+    }
+
+    quint64 processCount = 0;
+    foreach(QString processes, processList) {
+        if(rxRange.indexIn(processes) >= 0) {
+            processCount += (rxRange.cap(2).toULongLong() - rxRange.cap(1).toULongLong()) + 1;
+        } else {
+            ++processCount;
+        }
+    }
+
+    QString shortLabel = QString("%1:[%2]").arg(processCount).arg(processList.join(","));
+    return (shortLabel.count() > maxEdgeLabelSize) ? shortLabel.left(maxEdgeLabelSize - 3) + "..." : shortLabel;
+}
+
+//! Streaming preprocessor, keeping only the short labels
+class StreamingPreprocessor : public DotPreprocessor
+{
+public:
+    StreamingPreprocessor() : labels(0) {}
+    int labels;
+
+protected:
+    Attributes decodeNodeLabel(const QString &label) const
+    {
+        Attributes attributes;
+        attributes.insert(0, shortNodeLabel(label));
+        return attributes;
+    }
+
+    Attributes decodeEdgeLabel(const QString &label) const
+    {
+        Attributes attributes;
+        attributes.insert(0, shortEdgeLabel(label));
+        return attributes;
+    }
+
+    QString storeNodeLabel(const qint64 &id, const Attributes &attributes) { Q_UNUSED(id) ++labels; return attributes.value(0).toString(); }
+    QString storeEdgeLabel(const qint64 &id, const Attributes &attributes) { Q_UNUSED(id) ++labels; return attributes.value(0).toString(); }
+};
+
+//! The preprocessor as it was, with a QRegExp for nodes, edges and labels on every line
+static QString regExpPreprocess(const QString &content, int *labels)
+{
+    QString retval;
+
+    QRegExp rxLabel = QRegExp("label=\"(.*)\"", Qt::CaseInsensitive);
+    rxLabel.setMinimal(true);  // non-greedy
+
+    QRegExp rxNode = QRegExp("^\\s+([0-9\\-]+)\\s\\[.*fillcolor.*\\]", Qt::CaseInsensitive, QRegExp::RegExp2);
+    QRegExp rxEdge = QRegExp("^\\s+([0-9\\-]+)\\s->\\s([0-9\\-]+)\\s\\[.*\\]", Qt::CaseInsensitive, QRegExp::RegExp2);
+
+    foreach(QString line, content.split('\n')) {
+        if(rxNode.indexIn(line) >= 0 && rxNode.captureCount() == 1) {
+            if(rxLabel.indexIn(line) >= 0 && rxLabel.captureCount() == 1) {
+                QString label = rxLabel.cap(1);
+                ++(*labels);
+                line = line.replace(label, shortNodeLabel(label));
+            }
+        } else if(rxEdge.indexIn(line) >= 0 && rxEdge.captureCount() == 2) {
+            if(rxLabel.indexIn(line) >= 0 && rxLabel.captureCount() == 1) {
+                QString label = rxLabel.cap(1);
+                ++(*labels);
+                line = line.replace(label, shortEdgeLabel(label));
+            }
+        }
+
+        retval += line;
+    }
+
+    return retval;
+}
+
+/*! \brief Builds a STAT-like call graph; every frame splits its parent's ranks into interleaved subsets, so that
+           the edge labels carry long range lists like those of a real job
+ */
+static QString syntheticGraph(int frames, quint64 ranks)
+{
+    static const int fanOut = 4;
+
+    QString content;
+    QTextStream stream(&content);
+
+    stream << "digraph G {\n";
+    stream << "\tnode [shape=record,style=filled,labeljust=c,height=0.2];\n";
+    stream << "\t0 [pos=\"0,0\", label=\"/\", fillcolor=\"#ffffff\", fontcolor=\"#000000\"];\n";
+
+    for(int frame = 1; frame < frames; ++frame) {
+        int parent = (frame - 1) / fanOut;
+        int depth = 0;
+        for(int ancestor = parent; ancestor > 0; ancestor = (ancestor - 1) / fanOut) {
+            ++depth;
+        }
+
+        stream << "\t" << frame << " [label=\"function_" << frame << "@/usr/src/application/module_" << (frame % 97)
+               << "/source_file_" << (frame % 13) << ".c:" << (frame % 1000) + 1
+               << "\", fillcolor=\"#" << QString::number(frame % 0xffffff, 16).rightJustified(6, '0')
+               << "\", fontcolor=\"#000000\"];\n";
+
+        // The frame gets every fanOut^(depth+1)'th rank, starting from its position among its siblings
+        quint64 stride = 1;
+        for(int i = 0; i <= depth && stride < ranks; ++i) {
+            stride *= fanOut;
+        }
+        quint64 offset = (frame - 1) % fanOut;
+
+        QStringList ranges;
+        quint64 count = 0;
+        for(quint64 rank = offset; rank < ranks && ranges.count() < 1024; rank += stride * 2) {
+            quint64 last = qMin(rank + stride - 1, ranks - 1);
+            ranges << ((last > rank) ? QString("%1-%2").arg(rank).arg(last) : QString::number(rank));
+            count += (last - rank) + 1;
+        }
+
+        stream << "\t" << parent << " -> " << frame << " [label=\"" << count << ":[" << ranges.join(",") << "]\"];\n";
+    }
+
+    stream << "}\n";
+    stream.flush();
+
+    return content;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    int frames = (args.count() > 1) ? args.at(1).toInt() : 100000;
+    quint64 ranks = (args.count() > 2) ? args.at(2).toULongLong() : 65536;
+    int repetitions = (args.count() > 3) ? args.at(3).toInt() : 3;
+
+    if(frames < 1 || ranks < 1) {
+        QTextStream(stderr) << "Usage: " << args.at(0) << " [frames=100000] [ranks=65536] [repetitions=3]" << endl;
+        return 1;
+    }
+
+    QString content = syntheticGraph(frames, ranks);
+    int bytes = content.toUtf8().size();
+
+    QTextStream out(stdout);
+    out << "# " << frames << " frames over " << ranks << " ranks; " << bytes << " bytes of DOT" << endl;
+    out << "implementation,repetition,bytes,milliseconds,megabytesPerSecond" << endl;
+
+    qint64 total[3] = { 0, 0, 0 };
+    static const char *implementations[3] = { "regexp", "streaming", "concurrent" };
+
+    for(int repetition = 0; repetition < repetitions; ++repetition) {
+        QString outputs[3];
+        int labels[3] = { 0, 0, 0 };
+
+        for(int implementation = 0; implementation < 3; ++implementation) {
+            QElapsedTimer time;
+            time.start();
+
+            if(implementation == 0) {
+                outputs[0] = regExpPreprocess(content, &labels[0]);
+            } else {
+                StreamingPreprocessor preprocessor;
+                preprocessor.setConcurrentDecode(implementation == 2);
+                outputs[implementation] = preprocessor.preprocess(content);
+                labels[implementation] = preprocessor.labels;
+            }
+
+            qint64 elapsed = time.elapsed();
+            total[implementation] += elapsed;
+
+            out << implementations[implementation] << "," << repetition << "," << bytes << "," << elapsed << ","
+                << ((elapsed > 0) ? ((double)bytes / 1048576.0) / ((double)elapsed / 1000.0) : 0.0) << endl;
+        }
+
+        // The old preprocessor dropped the line breaks; everything else has to match
+        for(int implementation = 1; implementation < 3; ++implementation) {
+            if(labels[0] != labels[implementation] || outputs[0] != outputs[implementation].remove('\n')) {
+                QTextStream(stderr) << implementations[implementation] << " output differs on repetition " << repetition
+                                    << " (" << labels[0] << " and " << labels[implementation] << " labels)" << endl;
+                return 2;
+            }
+        }
+    }
+
+    if(repetitions > 0 && total[1] > 0 && total[2] > 0) {
+        out << "# mean regexp " << total[0] / repetitions << " ms; mean streaming " << total[1] / repetitions
+            << " ms; mean concurrent " << total[2] / repetitions << " ms on " << QThread::idealThreadCount()
+            << " threads; speedup " << (double)total[0] / (double)total[1] << "x serial, "
+            << (double)total[0] / (double)total[2] << "x concurrent" << endl;
+    }
+
+    return 0;
+}
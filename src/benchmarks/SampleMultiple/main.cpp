@@ -0,0 +1,164 @@
+/*!
+   \file main.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include <QtCore>
+
+#include <STAT_FrontEnd.h>
+#include <CompiledAdapter/Session.h>
+
+using namespace Plugins::SWAT;
+using namespace Plugins::CompiledAdapter;
+
+/*! \brief Compares the wall time of batched multi-trace sampling against gathering each trace individually
+
+    Usage: SampleMultipleBenchmark <pid> [traceCount=100] [traceFrequency=10] [repetitions=3]
+
+    Attaches to the running job with the given launcher PID, then alternates between both sampleMultiple() modes.
+    Each run is printed as a CSV row: mode,repetition,traces,milliseconds,files
+ */
+class Benchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    Benchmark() : m_Files(0), m_Failed(false) {}
+
+    int files() const { return m_Files; }
+    bool failed() const { return m_Failed; }
+    void reset() { m_Files = 0; m_Failed = false; }
+
+public slots:
+    void sampled(QString filename, QUuid id)
+    {
+        Q_UNUSED(filename)
+        Q_UNUSED(id)
+        ++m_Files;
+    }
+
+    void failed(QString message, QUuid id)
+    {
+        Q_UNUSED(id)
+        m_Failed = true;
+        QTextStream(stderr) << message << endl;
+    }
+
+private:
+    int m_Files;
+    bool m_Failed;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    if(args.count() < 2) {
+        QTextStream(stderr) << "Usage: " << args.at(0) << " <pid> [traceCount=100] [traceFrequency=10] [repetitions=3]" << endl;
+        return 1;
+    }
+
+    IAdapter::AttachOptions options;
+    options.pid = args.at(1).toULongLong();
+
+    STAT_FrontEnd *defaults = new STAT_FrontEnd();
+    options.toolDaemonPath = QString(defaults->getToolDaemonExe());
+    options.filterPath = QString(defaults->getFilterPath());
+    delete defaults;
+
+    options.logFlags = IAdapter::Log_None;
+    options.verboseFlags = IAdapter::Verbose_None;
+    options.debugFlags = IAdapter::Debug_None;
+
+    options.topologyType = IAdapter::Topology_Auto;
+    options.processesPerNode = 8;
+    options.shareApplicationNodes = false;
+
+    options.remoteShell = "rsh";
+    options.remoteHost = "localhost";
+
+    options.sampleType = IAdapter::Sample_FunctionNameOnly;
+    options.withThreads = false;
+    options.clearOnSample = true;
+    options.retryCount = 5;
+    options.retryFrequency = 10;
+    options.traceCount = (args.count() > 2) ? args.at(2).toULongLong() : 100;
+    options.traceFrequency = (args.count() > 3) ? args.at(3).toULongLong() : 10;
+    options.nonStop = false;
+    options.perturbationBudget = 0;
+    options.runTimeBeforeSample = 0;
+
+    int repetitions = (args.count() > 4) ? args.at(4).toInt() : 3;
+
+    Benchmark benchmark;
+    Session session(QUuid::createUuid());
+    QObject::connect(&session, SIGNAL(sampled(QString,QUuid)), &benchmark, SLOT(sampled(QString,QUuid)));
+    QObject::connect(&session, SIGNAL(failed(QString,QUuid)), &benchmark, SLOT(failed(QString,QUuid)));
+
+    session.attach(options);
+    if(benchmark.failed()) {
+        return 2;
+    }
+
+    QTextStream out(stdout);
+    out << "mode,repetition,traces,milliseconds,files" << endl;
+
+    qint64 total[2] = { 0, 0 };
+    static const char *modes[2] = { "batched", "individual" };
+
+    for(int repetition = 0; repetition < repetitions; ++repetition) {
+        for(int mode = 0; mode < 2; ++mode) {
+            options.gatherIndividualSamples = (mode == 1);
+            benchmark.reset();
+
+            QTime time;
+            time.start();
+            session.sampleMultiple(options);
+            int elapsed = time.elapsed();
+
+            if(benchmark.failed()) {
+                session.detach();
+                return 3;
+            }
+
+            total[mode] += elapsed;
+            out << modes[mode] << "," << repetition << "," << options.traceCount << "," << elapsed << ","
+                << benchmark.files() << endl;
+        }
+    }
+
+    session.detach();
+
+    if(repetitions > 0 && total[0] > 0) {
+        out << "# mean batched " << total[0] / repetitions << " ms; mean individual " << total[1] / repetitions
+            << " ms; speedup " << (double)total[1] / (double)total[0] << "x" << endl;
+    }
+
+    return 0;
+}
+
+#include "main.moc"
@@ -0,0 +1,413 @@
+/*!
+   \file main.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include <QtCore>
+
+#include <STAT_FrontEnd.h>
+#include <CompiledAdapter/Session.h>
+#include <CompiledAdapter/TopologyPlanner.h>
+
+using namespace Plugins::SWAT;
+using namespace Plugins::CompiledAdapter;
+
+/*! \brief Measures how MRNet tree launch, connect and gather times scale with the tree topology
+
+    Usage: TopologyBenchmark (--pid <pid> | --launch "<launcher command>") [options]
+      --topology <spec>     Topology to test; repeatable.  One of: auto, planned, flat, depth:<n>, fanout:<n>,
+                            user:<a-b-...>.  Defaults to flat, fanout:16, fanout:64, depth:2, depth:3, auto, planned
+      --traces <n,n,...>    Trace counts to gather with each topology (default 1,10,100)
+      --frequency <ms>      Trace frequency (default 10)
+      --nodes <host,...>    Hosts for the communication processes
+      --procs <n>           Communication processes per host (default 8)
+      --repetitions <n>     Number of times to run each topology (default 3)
+      --format json|csv     Report format (default json)
+      --output <file>       Write the report to a file instead of stdout
+
+    For every topology and repetition the tools are started from scratch, attached (or launched), sampled at
+    each trace count and shut down.  Every phase reported through Session::phaseTimed() is recorded, so the
+    report has the launch, connect and gather times for each combination.  "planned" uses a TopologyPlanner
+    that starts from the default model and is refit by each planned gather; "auto" leaves the choice to STAT.
+ */
+class Benchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Phase {
+        QString topology;
+        int repetition;
+        QString operation;
+        quint64 traceCount;
+        QString phase;
+        qint64 milliseconds;
+    };
+
+    Benchmark() : m_Repetition(0), m_TraceCount(0), m_Failed(false) {}
+
+    void setRun(const QString &topology, int repetition) { m_Topology = topology; m_Repetition = repetition; }
+    void setOperation(const QString &operation, quint64 traceCount) { m_Operation = operation; m_TraceCount = traceCount; }
+
+    bool failed() const { return m_Failed; }
+    void reset() { m_Failed = false; }
+
+    const QList<Phase> &phases() const { return m_Phases; }
+    const QStringList &errors() const { return m_Errors; }
+
+public slots:
+    void phaseTimed(QString phase, qint64 milliseconds, QUuid id)
+    {
+        Q_UNUSED(id)
+
+        Phase entry;
+        entry.topology = m_Topology;
+        entry.repetition = m_Repetition;
+        entry.operation = m_Operation;
+        entry.traceCount = m_TraceCount;
+        entry.phase = phase;
+        entry.milliseconds = milliseconds;
+        m_Phases.append(entry);
+    }
+
+    void failed(QString message, QUuid id)
+    {
+        Q_UNUSED(id)
+        m_Failed = true;
+        m_Errors.append(QString("%1 (repetition %2, %3): %4").arg(m_Topology).arg(m_Repetition).arg(m_Operation).arg(message));
+        QTextStream(stderr) << m_Errors.last() << endl;
+    }
+
+private:
+    QString m_Topology;
+    int m_Repetition;
+    QString m_Operation;
+    quint64 m_TraceCount;
+    bool m_Failed;
+
+    QList<Phase> m_Phases;
+    QStringList m_Errors;
+};
+
+static QString quoted(QString value)
+{
+    value.replace("\\", "\\\\");
+    value.replace("\"", "\\\"");
+    return QString("\"%1\"").arg(value);
+}
+
+/*! \brief Applies a topology argument to the options
+    \returns false if the specification wasn't understood
+ */
+static bool setTopology(const QString &topology, IAdapter::Options &options, bool &planned)
+{
+    planned = false;
+    options.topologySpecification = QString();
+
+    QString type = topology.section(':', 0, 0);
+    QString value = topology.section(':', 1);
+
+    if(type == "auto") {
+        options.topologyType = IAdapter::Topology_Auto;
+    } else if(type == "planned") {
+        options.topologyType = IAdapter::Topology_Auto;
+        planned = true;
+    } else if(type == "flat") {
+        options.topologyType = IAdapter::Topology_Depth;
+        options.topologySpecification = "0";
+    } else if(type == "depth" && !value.isEmpty()) {
+        options.topologyType = IAdapter::Topology_Depth;
+        options.topologySpecification = value;
+    } else if(type == "fanout" && !value.isEmpty()) {
+        options.topologyType = IAdapter::Topology_FanOut;
+        options.topologySpecification = value;
+    } else if(type == "user" && !value.isEmpty()) {
+        options.topologyType = IAdapter::Topology_User;
+        options.topologySpecification = value;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+static void writeCsv(QTextStream &out, const Benchmark &benchmark)
+{
+    out << "topology,repetition,operation,traces,phase,milliseconds" << endl;
+    foreach(Benchmark::Phase phase, benchmark.phases()) {
+        out << phase.topology << "," << phase.repetition << "," << phase.operation << "," << phase.traceCount << ","
+            << quoted(phase.phase) << "," << phase.milliseconds << endl;
+    }
+}
+
+static void writeJson(QTextStream &out, const Benchmark &benchmark, const QStringList &topologies,
+                      const QList<quint64> &traceCounts, int repetitions)
+{
+    QStringList topologyList, traceList, errorList;
+    foreach(QString topology, topologies) {
+        topologyList.append(quoted(topology));
+    }
+    foreach(quint64 traceCount, traceCounts) {
+        traceList.append(QString::number(traceCount));
+    }
+    foreach(QString error, benchmark.errors()) {
+        errorList.append(quoted(error));
+    }
+
+    out << "{" << endl;
+    out << "  \"benchmark\": \"topology\"," << endl;
+    out << "  \"date\": " << quoted(QDateTime::currentDateTime().toString(Qt::ISODate)) << "," << endl;
+    out << "  \"host\": " << quoted(QString::fromLocal8Bit(qgetenv("HOSTNAME"))) << "," << endl;
+    out << "  \"repetitions\": " << repetitions << "," << endl;
+    out << "  \"topologies\": [" << topologyList.join(", ") << "]," << endl;
+    out << "  \"traceCounts\": [" << traceList.join(", ") << "]," << endl;
+    out << "  \"errors\": [" << errorList.join(", ") << "]," << endl;
+
+    // Summary of each phase per topology, operation and trace count; this is what site defaults are picked from
+    QMap<QString, QList<qint64> > times;
+    QStringList order;
+    foreach(Benchmark::Phase phase, benchmark.phases()) {
+        QString key = QString("%1\t%2\t%3\t%4").arg(phase.topology).arg(phase.operation).arg(phase.traceCount).arg(phase.phase);
+        if(!times.contains(key)) {
+            order.append(key);
+        }
+        times[key].append(phase.milliseconds);
+    }
+
+    out << "  \"summary\": [" << endl;
+    for(int i = 0; i < order.count(); ++i) {
+        QStringList fields = order.at(i).split('\t');
+        QList<qint64> values = times.value(order.at(i));
+        qSort(values);
+
+        qint64 total = 0;
+        foreach(qint64 value, values) {
+            total += value;
+        }
+
+        out << "    {\"topology\": " << quoted(fields.at(0)) << ", \"operation\": " << quoted(fields.at(1))
+            << ", \"traces\": " << fields.at(2) << ", \"phase\": " << quoted(fields.at(3))
+            << ", \"count\": " << values.count() << ", \"minimum\": " << values.first()
+            << ", \"median\": " << values.at(values.count() / 2) << ", \"maximum\": " << values.last()
+            << ", \"mean\": " << total / values.count() << "}" << ((i + 1 < order.count()) ? "," : "") << endl;
+    }
+    out << "  ]," << endl;
+
+    out << "  \"phases\": [" << endl;
+    const QList<Benchmark::Phase> &phases = benchmark.phases();
+    for(int i = 0; i < phases.count(); ++i) {
+        const Benchmark::Phase &phase = phases.at(i);
+        out << "    {\"topology\": " << quoted(phase.topology) << ", \"repetition\": " << phase.repetition
+            << ", \"operation\": " << quoted(phase.operation) << ", \"traces\": " << phase.traceCount
+            << ", \"phase\": " << quoted(phase.phase) << ", \"milliseconds\": " << phase.milliseconds << "}"
+            << ((i + 1 < phases.count()) ? "," : "") << endl;
+    }
+    out << "  ]" << endl;
+    out << "}" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+
+    quint64 pid = 0;
+    QStringList launchArgs;
+    QStringList topologies;
+    QList<quint64> traceCounts;
+    quint64 traceFrequency = 10;
+    QStringList nodeList;
+    quint64 processesPerNode = 8;
+    int repetitions = 3;
+    QString format = "json";
+    QString outputFilename;
+
+    for(int i = 1; i < args.count(); ++i) {
+        QString arg = args.at(i);
+        QString value = (i + 1 < args.count()) ? args.at(i + 1) : QString();
+
+        if(arg == "--pid") {
+            pid = value.toULongLong();
+        } else if(arg == "--launch") {
+            launchArgs = value.split(" ", QString::SkipEmptyParts);
+        } else if(arg == "--topology") {
+            topologies.append(value);
+        } else if(arg == "--traces") {
+            foreach(QString traceCount, value.split(",", QString::SkipEmptyParts)) {
+                traceCounts.append(traceCount.toULongLong());
+            }
+        } else if(arg == "--frequency") {
+            traceFrequency = value.toULongLong();
+        } else if(arg == "--nodes") {
+            nodeList = value.split(",", QString::SkipEmptyParts);
+        } else if(arg == "--procs") {
+            processesPerNode = value.toULongLong();
+        } else if(arg == "--repetitions") {
+            repetitions = value.toInt();
+        } else if(arg == "--format") {
+            format = value;
+        } else if(arg == "--output") {
+            outputFilename = value;
+        } else {
+            QTextStream(stderr) << "Unknown argument: " << arg << endl;
+            return 1;
+        }
+        ++i;
+    }
+
+    if((pid == 0) == launchArgs.isEmpty() || (format != "json" && format != "csv")) {
+        QTextStream(stderr) << "Usage: " << args.at(0) << " (--pid <pid> | --launch \"<launcher command>\")"
+                            << " [--topology <spec>]... [--traces 1,10,100] [--frequency 10] [--nodes <host,...>]"
+                            << " [--procs 8] [--repetitions 3] [--format json|csv] [--output <file>]" << endl;
+        return 1;
+    }
+
+    if(topologies.isEmpty()) {
+        topologies << "flat" << "fanout:16" << "fanout:64" << "depth:2" << "depth:3" << "auto" << "planned";
+    }
+    if(traceCounts.isEmpty()) {
+        traceCounts << 1 << 10 << 100;
+    }
+
+    IAdapter::LaunchOptions launchOptions;
+    IAdapter::AttachOptions attachOptions;
+    IAdapter::Options &options = launchArgs.isEmpty() ? static_cast<IAdapter::Options &>(attachOptions)
+                                                      : static_cast<IAdapter::Options &>(launchOptions);
+    attachOptions.pid = pid;
+    launchOptions.args = launchArgs;
+
+    STAT_FrontEnd *defaults = new STAT_FrontEnd();
+    options.toolDaemonPath = QString(defaults->getToolDaemonExe());
+    options.filterPath = QString(defaults->getFilterPath());
+    delete defaults;
+
+    options.logFlags = IAdapter::Log_None;
+    options.verboseFlags = IAdapter::Verbose_None;
+    options.debugFlags = IAdapter::Debug_None;
+
+    options.nodeList = nodeList;
+    options.processesPerNode = processesPerNode;
+    options.shareApplicationNodes = false;
+
+    options.remoteShell = "rsh";
+    options.remoteHost = "localhost";
+
+    options.sampleType = IAdapter::Sample_FunctionNameOnly;
+    options.withThreads = false;
+    options.clearOnSample = true;
+    options.retryCount = 5;
+    options.retryFrequency = 10;
+    options.traceCount = 1;
+    options.traceFrequency = traceFrequency;
+    options.gatherIndividualSamples = false;
+    options.nonStop = false;
+    options.perturbationBudget = 0;
+    options.runTimeBeforeSample = 0;
+
+    foreach(QString topology, topologies) {
+        bool planned;
+        if(!setTopology(topology, options, planned)) {
+            QTextStream(stderr) << "Unknown topology specification: " << topology << endl;
+            return 1;
+        }
+    }
+
+    Benchmark benchmark;
+    TopologyPlanner planner;
+
+    foreach(QString topology, topologies) {
+        bool planned;
+        setTopology(topology, options, planned);
+
+        for(int repetition = 0; repetition < repetitions; ++repetition) {
+            benchmark.reset();
+            benchmark.setRun(topology, repetition);
+
+            // A new session for every run, so each one launches its own daemons and tree
+            Session session(QUuid::createUuid());
+            if(planned) {
+                session.setTopologyPlanner(&planner);
+            }
+            QObject::connect(&session, SIGNAL(phaseTimed(QString,qint64,QUuid)), &benchmark, SLOT(phaseTimed(QString,qint64,QUuid)));
+            QObject::connect(&session, SIGNAL(failed(QString,QUuid)), &benchmark, SLOT(failed(QString,QUuid)));
+
+            if(launchArgs.isEmpty()) {
+                benchmark.setOperation("attach", 1);
+                session.attach(attachOptions);
+            } else {
+                benchmark.setOperation("launch", 1);
+                session.launch(launchOptions);
+            }
+
+            if(benchmark.failed()) {
+                session.shutDown();
+                continue;
+            }
+
+            foreach(quint64 traceCount, traceCounts) {
+                IAdapter::SampleOptions sampleOptions = options;
+                sampleOptions.traceCount = traceCount;
+
+                benchmark.setOperation("sampleMultiple", traceCount);
+                session.sampleMultiple(sampleOptions);
+                if(benchmark.failed()) {
+                    break;
+                }
+            }
+
+            if(!benchmark.failed()) {
+                benchmark.setOperation("detach", 0);
+                session.detach();
+            }
+            session.shutDown();
+        }
+    }
+
+    QFile file;
+    if(outputFilename.isEmpty()) {
+        file.open(stdout, QIODevice::WriteOnly);
+    } else {
+        file.setFileName(outputFilename);
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Failed to open output file: " << outputFilename << endl;
+            return 1;
+        }
+    }
+
+    QTextStream out(&file);
+    if(format == "csv") {
+        writeCsv(out, benchmark);
+    } else {
+        writeJson(out, benchmark, topologies, traceCounts, repetitions);
+    }
+    out.flush();
+    file.close();
+
+    return benchmark.errors().isEmpty() ? 0 : 2;
+}
+
+#include "main.moc"
@@ -28,6 +28,10 @@
 
 #include "CompiledAdapter.h"
 
+#include "Session.h"
+
+#include <SettingManager/SettingManager.h>
+
 #include <MainWindow/MainWindow.h>
 
 #ifdef COMPILEDADAPTER_DEBUG
@@ -42,11 +46,31 @@ namespace CompiledAdapter {
 /*! \class CompiledAdapter
     \version 0.1.dev
     \brief SWAT FrontEnd adapter compiled directly with the libraries (STAT_FrontEnd.h interface)
+
+    Each FrontEnd is owned by a Session; the public verbs only queue the operation with the SessionScheduler
+    and return immediately.  Operations on different sessions run in parallel on pooled worker threads, up to
+    the "scheduler/maximumConcurrency" setting.  Errors are reported through the failed() signal.
+
+    Rendered samples are handed to the view in memory with sampledContent(); STAT's output files are removed
+    in the background unless the "sample/keepOutputFiles" setting is true (the default).
+
+    STAT's default paths are only read when first asked for, so that starting the GUI to look at a saved trace
+    doesn't construct a STAT_FrontEnd.  The time taken by construction, and by reading the defaults, is reported
+    through phaseTimed() with a null ID as the "Adapter Startup" and "Resolve Front End Defaults" phases.
  */
 
 CompiledAdapter::CompiledAdapter(QObject *parent) :
-    IAdapter(parent)
+    IAdapter(parent),
+    m_DefaultsResolved(false),
+    m_KeepOutputFiles(true),
+    m_StartupTime(0),
+    m_DefaultsTime(0),
+    m_StartupReported(false),
+    m_DefaultsReported(false)
 {
+    QElapsedTimer startupTime;
+    startupTime.start();
+
     setObjectName("CompiledAdapter");
 
 //    qputenv("prefix", "/opt/stat");
@@ -62,779 +86,264 @@ CompiledAdapter::CompiledAdapter(QObject *parent) :
 
 //    qputenv("MRNET_DEBUG_LEVEL", "5");
 
-    // Get default values from the FrontEnd and cache them in this object
-    STAT_FrontEnd *frontEnd = new STAT_FrontEnd();
-    m_DefaultFilterPath = QString(frontEnd->getFilterPath());
-    m_DefaultToolDaemonPath = QString(frontEnd->getToolDaemonExe());
-    m_InstallPath = QString(frontEnd->getInstallPrefix());
-    m_OutputPath = QString(frontEnd->getOutDir());
-    delete frontEnd;
-}
-
-CompiledAdapter::~CompiledAdapter()
-{
-    // Detach and shutdown any front ends
-    foreach(QUuid id, m_frontEnds.keys()) {
-        try {
-            if(isAttached(id)) {
-                detach(id);
-            }
-        } catch(...) { /* ignore */ }  //TODO: should probably log errors
-
-        try {
-            if(m_frontEnds.contains(id)) {
-                getFrontEnd(id)->shutDown();
-            }
-        } catch(...) { /* ignore */ }  //TODO: should probably log errors
-
-        m_running.removeAll(id);
-        m_attached.removeAll(id);
-    }
-
-    // Delete all of the FrontEnd objects
-    qDeleteAll(m_frontEnds);
-}
-
-QUuid CompiledAdapter::launch(const LaunchOptions &options)
-{
-    QUuid id = QUuid::createUuid();
-    launch(options, id);
-    return id;
-}
-
-void CompiledAdapter::launch(const LaunchOptions &options, const QUuid &id)
-{
-    StatError_t statError;
-
-    emit launching(id);
-    emit progress(1, id);
+    Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+    settingManager.beginGroup("Plugins/CompiledAdapter");
+    m_Scheduler.setMaximumConcurrency(settingManager.value("scheduler/maximumConcurrency",
+                                                           m_Scheduler.maximumConcurrency()).toInt());
+    m_KeepOutputFiles = settingManager.value("sample/keepOutputFiles", true).toBool();
+    settingManager.endGroup();
 
-    emit progressMessage("Starting Front End", id);
-    STAT_FrontEnd *frontEnd = setupFrontEnd(options, id);
+    m_TopologyPlanner.readSettings();
 
-//    options.args.pop_front();  // STATGUI.py just ignores the 'Launcher Exe' argument
-    foreach(QString arg, options.args) {
-        frontEnd->addLauncherArgv(arg.toLocal8Bit().data());
-    }
-    emit progress(5, id);
-
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::launchAndSpawnDaemons()";
-    Thread::sleep(100);
-#endif
-    emit progressMessage("Launch Daemons", id);
-    if(options.remoteHost == "localhost") {
-        statError = frontEnd->launchAndSpawnDaemons();
-    } else {
-        statError = frontEnd->launchAndSpawnDaemons(options.remoteHost.toLocal8Bit().data());
-    }
-    if(statError != STAT_OK) {
-        throw tr("Failed to launch daemons: %1").arg(frontEnd->getLastErrorMessage());
-    }
-    emit progress(10, id);
+    m_StartupTime = startupTime.elapsed();
 
 #ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "CompiledAdapter::launchMRNet()";
-    Thread::sleep(100);
+    qDebug() << __FILE__ << __LINE__ << "CompiledAdapter started in" << m_StartupTime << "ms";
 #endif
-    emit progressMessage("Connect to Daemons", id);
-    launchMRNet(options, id);
-    emit progress(15, id);
+}
 
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "CompiledAdapter::attachApplication()";
-    Thread::sleep(100);
-#endif
-    emit progressMessage("Attach to Application", id);
-    attachApplication(id);
-    emit progress(20, id);
+CompiledAdapter::~CompiledAdapter()
+{
+    // Drop queued work and cancel anything running, then shut down every front end
+    m_Scheduler.cancelAll();
+    m_Scheduler.waitForDone();
 
-    LaunchOptions launchOptions = options;
-    launchOptions.traceCount = 1;
-    launchOptions.traceFrequency = 1;
+    qDeleteAll(m_Sessions);
+    m_Sessions.clear();
 
-    OperationProgress operationProgress(30, 0.7);
-    sample(launchOptions, id, operationProgress);
-    emit progress(100, id);
+    qDeleteAll(m_ReattachOptions);
+    m_ReattachOptions.clear();
 
-    m_attached.append(id);
-    m_running.append(id);
-    emit launched(id);
+    // Keep the achieved gather times, so the next run plans with a tuned model
+    m_TopologyPlanner.writeSettings();
 }
 
-QUuid CompiledAdapter::attach(const AttachOptions &options)
+/*! \fn CompiledAdapter::createSession()
+    \brief Creates a new Session and relays its signals
+    \param id Unique ID of the FrontEnd that the session will own
+    \returns The newly created Session
+ */
+Session *CompiledAdapter::createSession(const QUuid &id)
 {
-    QUuid id = QUuid::createUuid();
-    attach(options, id);
-    return id;
+    reportStartupTimes();
+
+    Session *session = new Session(id);
+    session->setKeepOutputFiles(m_KeepOutputFiles);
+    session->setTopologyPlanner(&m_TopologyPlanner);
+
+    // Relay the session's signals; they are emitted from worker threads and delivered on this object's thread
+    connect(session, SIGNAL(progress(int,QUuid)), this, SIGNAL(progress(int,QUuid)));
+    connect(session, SIGNAL(progressMessage(QString,QUuid)), this, SIGNAL(progressMessage(QString,QUuid)));
+    connect(session, SIGNAL(launching(QUuid)), this, SIGNAL(launching(QUuid)));
+    connect(session, SIGNAL(launched(QUuid)), this, SIGNAL(launched(QUuid)));
+    connect(session, SIGNAL(attaching(QUuid)), this, SIGNAL(attaching(QUuid)));
+    connect(session, SIGNAL(attached(QUuid)), this, SIGNAL(attached(QUuid)));
+    connect(session, SIGNAL(detaching(QUuid)), this, SIGNAL(detaching(QUuid)));
+    connect(session, SIGNAL(detached(QUuid)), this, SIGNAL(detached(QUuid)));
+    connect(session, SIGNAL(pausing(QUuid)), this, SIGNAL(pausing(QUuid)));
+    connect(session, SIGNAL(paused(QUuid)), this, SIGNAL(paused(QUuid)));
+    connect(session, SIGNAL(resuming(QUuid)), this, SIGNAL(resuming(QUuid)));
+    connect(session, SIGNAL(resumed(QUuid)), this, SIGNAL(resumed(QUuid)));
+    connect(session, SIGNAL(sampling(QUuid)), this, SIGNAL(sampling(QUuid)));
+    connect(session, SIGNAL(sampled(QString,QUuid)), this, SIGNAL(sampled(QString,QUuid)));
+    connect(session, SIGNAL(sampledContent(QByteArray,QString,QUuid)), this, SIGNAL(sampledContent(QByteArray,QString,QUuid)));
+    connect(session, SIGNAL(canceling(QUuid)), this, SIGNAL(canceling(QUuid)));
+    connect(session, SIGNAL(canceled(QUuid)), this, SIGNAL(canceled(QUuid)));
+    connect(session, SIGNAL(failed(QString,QUuid)), this, SIGNAL(failed(QString,QUuid)));
+    connect(session, SIGNAL(phaseTimed(QString,qint64,QUuid)), this, SIGNAL(phaseTimed(QString,qint64,QUuid)));
+
+    connect(session, SIGNAL(detached(QUuid)), this, SLOT(sessionDetached(QUuid)));
+
+    m_Sessions.insert(id, session);
+
+    return session;
 }
 
-void CompiledAdapter::attach(const AttachOptions &options, const QUuid &id)
+/*! \fn CompiledAdapter::session()
+    \returns Session associated with the specified FrontEnd ID
+    \note Throws if the job has detached and its session was released; only reAttach() can use it then
+ */
+Session *CompiledAdapter::session(const QUuid &id)
 {
-    StatError_t statError;
-
-    emit attaching(id);
-
-    emit progressMessage("Starting Front End", id);
-    STAT_FrontEnd *frontEnd = setupFrontEnd(options, id);
-    emit progress(5, id);
-
-    emit progressMessage("Launch Daemons", id);
-    if(options.remoteHost == "localhost") {
-        statError = frontEnd->attachAndSpawnDaemons(options.pid);
-    } else {
-        statError = frontEnd->attachAndSpawnDaemons(options.pid, options.remoteHost.toLocal8Bit().data());
-    }
-    if(statError != STAT_OK) {
-        throw tr("Failed to launch daemons: %1").arg(frontEnd->getLastErrorMessage());
+    if(!m_Sessions.contains(id)) {
+        if(m_ReattachOptions.contains(id)) {
+            throw tr("The job is detached; reattach to it first.");
+        }
+        throw tr("FrontEnd with the specified ID was not found.");
     }
-    emit progress(10, id);
-
-    emit progressMessage("Connect to Daemons", id);
-    launchMRNet(options, id);
-    emit progress(15, id);
-
-    emit progressMessage("Attach to Application", id);
-    attachApplication(id);
-    emit progress(20, id);
 
-    AttachOptions attachOptions = options;
-    attachOptions.traceCount = 1;
-    attachOptions.traceFrequency = 1;
-
-    OperationProgress operationProgress(30, 0.7);
-    sample(attachOptions, id, operationProgress);
-    emit progress(100, id);
-
-    m_attached.append(id);
-    emit attached(id);
+    return m_Sessions.value(id);
 }
 
-STAT_FrontEnd *CompiledAdapter::setupFrontEnd(const Options &options, const QUuid &id)
+QUuid CompiledAdapter::launch(const LaunchOptions &options)
 {
-    StatError_t statError;
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
-
-    m_reattachOptions[id] = options;  // Save for possible later reattach
-
-    statError = frontEnd->setToolDaemonExe(options.toolDaemonPath.toLocal8Bit().data());
-    if(statError != STAT_OK) {
-        throw tr("STAT_FrontEnd::setToolDaemonExe() returned error: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    statError = frontEnd->setFilterPath(options.filterPath.toLocal8Bit().data());
-    if(statError != STAT_OK) {
-        throw tr("STAT_FrontEnd::setFilterPath() returned error: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    if(options.logFlags > 0) {
-        StatLog_t logType = STAT_LOG_NONE;
-        if(options.logFlags | Log_FrontEnd && options.logFlags | Log_BackEnd) {
-            logType = STAT_LOG_ALL;
-        } else if(options.logFlags | Log_FrontEnd) {
-            logType = STAT_LOG_FE;
-        } else if(options.logFlags | Log_BackEnd) {
-            logType = STAT_LOG_BE;
-        }
-
-        statError = frontEnd->startLog(logType, options.logPath.toLocal8Bit().data());
-        if(statError != STAT_OK) {
-            throw tr("Failed to start log: %1").arg(frontEnd->getLastErrorMessage());
-        }
-    }
-
-    if(options.verboseFlags | Verbose_Error && options.verboseFlags | Verbose_StdOut) {
-        frontEnd->setVerbose(STAT_VERBOSE_FULL);
-    } else if(options.verboseFlags | Verbose_Error) {
-        frontEnd->setVerbose(STAT_VERBOSE_ERROR);
-    } else if(options.verboseFlags | Verbose_StdOut) {
-        frontEnd->setVerbose(STAT_VERBOSE_STDOUT);
-    }
-
-    if(options.debugFlags & Debug_BackEnd) {
-        qputenv("LMON_DEBUG_BES", "1");
-    } else {
-        // Clear the environment variable (unsetenv is not compatible with MinGW or MSVC)
-        //NOTE: this _may_ fail on some systems (AIX?)
-        qputenv("LMON_DEBUG_BES", QByteArray());
-    }
-
-    frontEnd->setProcsPerNode(options.processesPerNode);
+    QUuid id = QUuid::createUuid();
+    m_Scheduler.enqueue(createSession(id), options);
+    return id;
+}
 
-    return frontEnd;
+QUuid CompiledAdapter::attach(const AttachOptions &options)
+{
+    QUuid id = QUuid::createUuid();
+    m_Scheduler.enqueue(createSession(id), options);
+    return id;
 }
 
 void CompiledAdapter::reAttach(const QUuid &id)
 {
-    if(!isAttached(id)) {
-        throw tr("Unable to reattach; already attached!");
-    }
-
-    if(!m_reattachOptions.contains(id)) {
-        throw tr("Unable to reattach; options not found in cache.");
-    }
-
-
-    IAdapter::AttachOptions *attachOptions = dynamic_cast<IAdapter::AttachOptions*>(&(m_reattachOptions[id]));
-    if(attachOptions) {
-        attach(*attachOptions, id);
-        return;
-    }
+    // A released session is started over, with the options it was created with
+    if(!m_Sessions.contains(id) && m_ReattachOptions.contains(id)) {
+        Options *options = m_ReattachOptions.take(id);
+
+        if(AttachOptions *attachOptions = dynamic_cast<AttachOptions *>(options)) {
+            m_Scheduler.enqueue(createSession(id), *attachOptions);
+        } else if(LaunchOptions *launchOptions = dynamic_cast<LaunchOptions *>(options)) {
+            m_Scheduler.enqueue(createSession(id), *launchOptions);
+        }
 
-    IAdapter::LaunchOptions *launchOptions = dynamic_cast<IAdapter::LaunchOptions*>(&(m_reattachOptions[id]));
-    if(launchOptions) {
-        launch(*launchOptions, id);
+        delete options;
         return;
     }
 
-    throw tr("Unable to reattach; valid options not found in cache.");
+    m_Scheduler.enqueue(session(id), SessionScheduler::Operation_ReAttach);
 }
 
-void CompiledAdapter::detach(const QUuid &id)
+void CompiledAdapter::detach(const QUuid &id, const DetachOptions &options)
 {
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::resume() frontEnd was null! This is not a valid value.");
-    }
-
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
-
-    StatError_t statError;
-
-    if(!isAttached(id)) {
-        throw tr("Unable to detach; not already attached.");
-    }
-
-    detaching(id);
-
-    if((statError = frontEnd->detachApplication(NULL, 0, false)) != STAT_OK) {
-        throw tr("Failed to detach from application: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    if((statError = waitAck(frontEnd)) != STAT_OK) {
-        throw tr("Failed to resume application: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    m_frontEnds.remove(id);
-    frontEnd->shutDown();
-    delete frontEnd;
-
-    m_running.removeAll(id);
-    m_attached.removeAll(id);
-    emit detached(id);
+    m_Scheduler.enqueue(session(id), options);
 }
 
 void CompiledAdapter::pause(const QUuid &id)
 {
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::pause() frontEnd was null! This is not a valid value.");
-    }
-
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
-
-    StatError_t statError;
-
-    // Can't pause if we're not running
-    if(!frontEnd->isRunning()) {
-        return;
-    }
-
-    emit pausing(id);
-
-    if((statError = frontEnd->pause()) != STAT_OK) {
-        throw tr("Failed to pause application: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    if((statError = waitAck(frontEnd)) != STAT_OK) {
-        throw tr("Failed to pause application: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    m_running.removeAll(id);
-    emit paused(id);
+    m_Scheduler.enqueue(session(id), SessionScheduler::Operation_Pause);
 }
 
 void CompiledAdapter::resume(const QUuid &id)
 {
-    //TODO: Should we just reattach if possible?
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::resume() frontEnd was null! This is not a valid value.");
-    }
-
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
-
-    StatError_t statError;
-
-    // Can't resume if we're already running
-    if(frontEnd->isRunning()) {
-        return;
-    }
-
-    emit resuming(id);
-
-    if((statError = frontEnd->resume()) != STAT_OK) {
-        throw tr("Failed to resume application: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    if((statError = waitAck(frontEnd)) != STAT_OK) {
-        throw tr("Failed to resume application: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    m_running.append(id);
-    emit resumed(id);
+    m_Scheduler.enqueue(session(id), SessionScheduler::Operation_Resume);
 }
 
 void CompiledAdapter::sample(const SampleOptions &options, const QUuid &id)
 {
-    OperationProgress operationProgress;
-    sample(options, id, operationProgress);
-}
-
-void CompiledAdapter::sample(const SampleOptions &options, const QUuid &id, OperationProgress &operationProgress)
-{
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::sample() frontEnd was null! This is not a valid value.");
-    }
-
-    // Store the progress scale, we're going to be messing with it for sub-operations
-    float operationProgressScale = operationProgress.scale;
-
-    // Run the application for the specified period before we begin
-    operationProgress.scale = 0.05 * operationProgressScale;  // (((our steps) * (our scale)) / (sub-op scale))
-    preSampleRunWait(options.runTimeBeforeSample, id, operationProgress);
-
-
-    // Rescale the progress for the following operations
-    operationProgress.scale = 0.85 * operationProgressScale;
-
-    SampleOptions sampleOneOptions = options;
-    sampleOneOptions.traceCount = 1;
-    sampleOneOptions.traceFrequency = 1;
-
-    sampleOne(sampleOneOptions, id, operationProgress);
+    m_Scheduler.enqueue(session(id), SessionScheduler::Operation_Sample, options);
 }
 
 void CompiledAdapter::sampleMultiple(const SampleOptions &options, const QUuid &id)
 {
-    OperationProgress operationProgress;
-    sampleMultiple(options, id, operationProgress);
+    m_Scheduler.enqueue(session(id), SessionScheduler::Operation_SampleMultiple, options);
 }
 
-void CompiledAdapter::sampleMultiple(const SampleOptions &options, const QUuid &id, OperationProgress &operationProgress)
+/*! \fn CompiledAdapter::sessionDetached()
+    \brief Releases a session once it has fully detached; its options are kept for a later reattach
+    \note Sessions that kept their daemons running for a quick reattach are held on to
+ */
+void CompiledAdapter::sessionDetached(QUuid id)
 {
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::sampleMultiple() frontEnd was null! This is not a valid value.");
-    }
-
-    StatError_t statError;
-
-    // Store the progress scale, we're going to be messing with it for sub-operations
-    float operationProgressScale = operationProgress.scale;
-
-    // Run the application for the specified period before we begin
-    operationProgress.scale = 0.05 * operationProgressScale;  // (((our steps) * (our scale)) / (sub-op scale))
-    preSampleRunWait(options.runTimeBeforeSample, id, operationProgress);
-
-    // Rescale the progress for the following operations
-    operationProgress.scale = 0.85 * operationProgressScale / options.traceCount;
-
-    SampleOptions tempOptions = options;
-    tempOptions.traceCount = 1;
-    tempOptions.traceFrequency = 0;
-    for(quint64 i=0; i < options.traceCount; ++i) {
-        if(i == 1) tempOptions.clearOnSample = false;
-        sampleOne(tempOptions, id, operationProgress);
-    }
-
-
-    emit progressMessage("Gather Stack Traces", id);
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
-    if((statError = frontEnd->gatherTraces(false)) != STAT_OK) {
-        throw tr("Failed to gather stack traces:\n%1").arg(frontEnd->getLastErrorMessage());
+    Session *session = m_Sessions.value(id, NULL);
+    if(!session || session->toolsRunning()) {
+        return;
     }
 
-    if((statError = waitAck(frontEnd)) != STAT_OK) {
-        throw tr("Failed to gather stack traces: %1").arg(frontEnd->getLastErrorMessage());
-    }
-    operationProgress.value += operationProgressScale * 5;
-    emit progress(operationProgress.value, id);
+    m_Sessions.remove(id);
 
-    emit progressMessage("Render Stack Traces", id);
-    QFileInfo fileInfo(frontEnd->getLastDotFilename());
-    if(!fileInfo.exists()) {
-        throw tr("File does not exist: '%1'").arg(fileInfo.absoluteFilePath());
+    if(const AttachOptions *attachOptions = dynamic_cast<const AttachOptions *>(session->reattachOptions())) {
+        m_ReattachOptions.insert(id, new AttachOptions(*attachOptions));
+    } else if(const LaunchOptions *launchOptions = dynamic_cast<const LaunchOptions *>(session->reattachOptions())) {
+        m_ReattachOptions.insert(id, new LaunchOptions(*launchOptions));
     }
 
-    emit sampled(fileInfo.absoluteFilePath(), id);
-
-
-    operationProgress.value += operationProgressScale * 43;
-    emit progress(operationProgress.value, id);
+    m_Scheduler.release(session);
 }
 
-/*! \fn CompiledAdapter::preSampleRunWait()
-    \brief Helper function for sample operations where a required wait period occurs
-    \param id Unique ID associated with the FrontEnd
-    \param runTimeWait time in seconds to run the application before returning
-    \param operationProgress
+/*! \fn CompiledAdapter::scheduler()
+    \returns Scheduler running the session operations; exposes the concurrency limit and queue statistics
  */
-void CompiledAdapter::preSampleRunWait(const quint64 &runTimeWait, const QUuid &id, OperationProgress &operationProgress)
+SessionScheduler &CompiledAdapter::scheduler()
 {
-    float operationProgressValue = operationProgress.value;
-
-    if(runTimeWait > 0) {
-        if(!isRunning(id)) {
-            resume(id);
-        }
-
-        emit progressMessage("Waiting for Pre-Sample Run Time", id);
-
-        QTime start = QTime::currentTime().addSecs(runTimeWait);
-
-        static const int progressSteps = 10;
-        QTime progressNotify = QTime::currentTime().addMSecs((runTimeWait * 1000) / progressSteps);
-
-        while(QTime::currentTime() < start) {
-            if(QTime::currentTime() > progressNotify) {
-                progressNotify = QTime::currentTime().addMSecs((runTimeWait * 1000) / progressSteps);
-                operationProgress.value += operationProgress.scale * 10;
-                emit progress(operationProgress.value, id);
-            }
-
-            QApplication::processEvents();
-            Thread::sleep(5);
-        }
-    }
-
-    // Ensure that we always finish at 100% for this operation
-    operationProgress.value = operationProgressValue + operationProgress.scale * 100;
-    emit progress(operationProgress.value, id);
+    return m_Scheduler;
 }
 
-void CompiledAdapter::sampleOne(const SampleOptions &options, const QUuid &id, OperationProgress &operationProgress)
+/*! \fn CompiledAdapter::resolveDefaults()
+    \brief Reads STAT's default paths from a temporary FrontEnd, the first time any of them is asked for
+ */
+void CompiledAdapter::resolveDefaults() const
 {
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::sampleOne() frontEnd was null! This is not a valid value.");
-    }
-
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
+    QMutexLocker locker(&m_DefaultsLock);
 
-    float operationProgressScale = operationProgress.scale;
-
-    StatError_t statError;
-
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::pause()";
-    Thread::sleep(100);
-#endif
-    if(frontEnd->isRunning()) {
-        if((statError = frontEnd->pause()) != STAT_OK) {
-            throw tr("Failed to pause application during sample: %1").arg(frontEnd->getLastErrorMessage());
-        }
-    }
-    emit paused(id);
-
-    operationProgress.value += operationProgressScale * 7;
-    emit progress(operationProgress.value, id);
-
-    emit progressMessage("Sample Stack Trace", id);
-    StatSample_t sampleType = STAT_FUNCTION_NAME_ONLY;
-    if(options.sampleType == Sample_FunctionAndPC) {
-        sampleType = STAT_FUNCTION_AND_PC;
-    } else if(options.sampleType == Sample_FunctionAndLine) {
-        sampleType = STAT_FUNCTION_AND_LINE;
-    }
-
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::sampleStackTraces()";
-    Thread::sleep(100);
-#endif
-    //! \note The compiler warning for the string conversion is in the STAT_FrontEnd header; not our issue
-    statError = frontEnd->sampleStackTraces(sampleType, options.withThreads, options.clearOnSample,
-                                            options.traceCount, options.traceFrequency,
-                                            options.retryCount, options.retryFrequency,
-                                            false, const_cast<char *>("NULL"));
-    if(statError != STAT_OK) {
-        throw tr("Failed to sample stack trace: %1").arg(frontEnd->getLastErrorMessage());
+    if(m_DefaultsResolved) {
+        return;
     }
 
+    QElapsedTimer defaultsTime;
+    defaultsTime.start();
 
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::waitAck()";
-    Thread::sleep(100);
-#endif
-    if((statError = waitAck(frontEnd)) != STAT_OK) {
-        throw tr("Failed to sample stack trace: %1").arg(frontEnd->getLastErrorMessage());
-    }
-    operationProgress.value += operationProgressScale * 36;
-    emit progress(operationProgress.value, id);
-
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::gatherLastTrace()";
-    Thread::sleep(100);
-#endif
-    emit progressMessage("Gather Stack Trace", id);
-    if((statError = frontEnd->gatherLastTrace(false)) != STAT_OK) {
-        throw tr("Failed to gather stack trace: %1").arg(frontEnd->getLastErrorMessage());
-    }
+    STAT_FrontEnd *frontEnd = new STAT_FrontEnd();
+    m_DefaultFilterPath = QString(frontEnd->getFilterPath());
+    m_DefaultToolDaemonPath = QString(frontEnd->getToolDaemonExe());
+    m_InstallPath = QString(frontEnd->getInstallPrefix());
+    m_OutputPath = QString(frontEnd->getOutDir());
+    delete frontEnd;
 
-    if((statError = waitAck(frontEnd)) != STAT_OK) {
-        throw tr("Failed to gather stack trace: %1").arg(frontEnd->getLastErrorMessage());
-    }
-    operationProgress.value += operationProgressScale * 14;
-    emit progress(operationProgress.value, id);
+    m_DefaultsTime = defaultsTime.elapsed();
+    m_DefaultsResolved = true;
 
 #ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::getLastDotFilename()";
-    Thread::sleep(100);
+    qDebug() << __FILE__ << __LINE__ << "STAT defaults resolved in" << m_DefaultsTime << "ms";
 #endif
-    emit progressMessage("Render Stack Trace", id);
-    QFileInfo fileInfo(frontEnd->getLastDotFilename());
-    if(!fileInfo.exists()) {
-        throw tr("File does not exist: '%1'").arg(fileInfo.absoluteFilePath());
-    }
-
-
-    emit sampled(fileInfo.absoluteFilePath(), id);
-
-    operationProgress.value += operationProgressScale * 43;
-    emit progress(operationProgress.value, id);
 }
 
-/*! \fn CompiledAdapter::launchMRNet()
-    \param options Topology options
-    \param id Unique ID associated with SWAT FrontEnd
- */
-void CompiledAdapter::launchMRNet(const TopologyOptions &options, const QUuid &id) {
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::launchMRNet() frontEnd was null! This is not a valid value.");
-    }
-
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
-
-    StatError_t statError;
-
-    StatTopology_t topologyType = STAT_TOPOLOGY_AUTO;
-    if(options.topologyType == Topology_Depth) {
-        topologyType = STAT_TOPOLOGY_DEPTH;
-    } else if(options.topologyType == Topology_FanOut) {
-        topologyType = STAT_TOPOLOGY_FANOUT;
-    } else if(options.topologyType == Topology_User) {
-        topologyType = STAT_TOPOLOGY_USER;
-    }
-
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::launchMrnetTree()";
-    Thread::sleep(100);
-#endif
-    statError = frontEnd->launchMrnetTree(topologyType,
-                                          options.topologySpecification.toLocal8Bit().data(),
-                                          options.nodeList.join(" ").toLocal8Bit().data(),
-                                          false,
-                                          options.shareApplicationNodes);
-    if(statError != STAT_OK) {
-        throw tr("Failed to launch MRNet tree: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::connectMrnetTree()";
-    Thread::sleep(100);
-#endif
-    while((statError = frontEnd->connectMrnetTree(false)) == STAT_PENDING_ACK) {
-        QApplication::processEvents();
-        Thread::sleep(5);
-    }
-    if(statError != STAT_OK) {
-        throw tr("Failed to connect MRNet tree: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
+const QString &CompiledAdapter::defaultFilterPath() const
+{
+    resolveDefaults();
+    return m_DefaultFilterPath;
 }
 
-/*! \fn CompiledAdapter::attachApplication()
-    \param id Unique ID associated with SWAT FrontEnd
- */
-void CompiledAdapter::attachApplication(const QUuid &id)
+const QString &CompiledAdapter::defaultToolDaemonPath() const
 {
-    if(!m_frontEnds.contains(id)) {
-        throw tr("CompiledAdapter::attachApplication() frontEnd was null! This is not a valid value.");
-    }
-
-    STAT_FrontEnd *frontEnd = getFrontEnd(id);
-
-    StatError_t statError;
-
-#ifdef COMPILEDADAPTER_DEBUG
-    Thread::sleep(100);
-    qDebug() << "STAT_FrontEnd::attachApplication()";
-    Thread::sleep(100);
-#endif
-    statError = frontEnd->attachApplication(false);
-    if(statError != STAT_OK) {
-        throw tr("Failed to attach application: %1").arg(frontEnd->getLastErrorMessage());
-    }
-
-    if((statError = waitAck(frontEnd)) != STAT_OK) {
-        throw tr("Failed to attach application: %1").arg(frontEnd->getLastErrorMessage());
-    }
+    resolveDefaults();
+    return m_DefaultToolDaemonPath;
 }
-
-/*! \fn CompiledAdapter::waitAck()
-    \brief Helper function that waits for a FrontEnd to do an operation while the GUI continues to be responsive.
- */
-StatError_t CompiledAdapter::waitAck(STAT_FrontEnd *frontEnd)
+const QString &CompiledAdapter::installPath() const
 {
-    StatError_t statError;
-    while((statError = frontEnd->receiveAck(false)) == STAT_PENDING_ACK) {
-        QApplication::processEvents();
-        Thread::sleep(5);
-    }
-    return statError;
+    resolveDefaults();
+    return m_InstallPath;
+}
+const QString &CompiledAdapter::outputPath() const
+{
+    resolveDefaults();
+    return m_OutputPath;
 }
 
-/*! \fn CompiledAdapter::getFrontEnd()
-    \param id Unique ID
-    \returns STAT_FrontEnd object associated with unique ID
+/*! \fn CompiledAdapter::connectNotify()
+    \brief Reports the startup time once something listens to phaseTimed()
  */
-STAT_FrontEnd *CompiledAdapter::getFrontEnd(const QUuid &id)
+void CompiledAdapter::connectNotify(const char *signal)
 {
-    if(id.isNull()) {
-        throw tr("CompiledAdapter::getFrontEnd() ID not valid");
-    }
+    IAdapter::connectNotify(signal);
 
-    if(m_frontEnds.contains(id)) {
-        return m_frontEnds[id];
+    if(!m_StartupReported && QLatin1String(signal) == SIGNAL(phaseTimed(QString,qint64,QUuid))) {
+        // Not emitted from within connect() itself
+        QTimer::singleShot(0, this, SLOT(reportStartupTimes()));
     }
-
-    STAT_FrontEnd *frontEnd = new STAT_FrontEnd;
-    m_frontEnds.insert(id, frontEnd);
-    return frontEnd;
 }
 
-/*! \fn CompiledAdapter::errorToString()
-    \brief Converts STAT error enum value to QString for debug display
-    \param StatError_t
-    \returns string describing error
+/*! \fn CompiledAdapter::reportStartupTimes()
+    \brief Emits the startup timings that haven't been reported yet
  */
-QString CompiledAdapter::errorToString(StatError_t error)
+void CompiledAdapter::reportStartupTimes()
 {
-    switch(error) {
-    case STAT_OK:
-        return tr("OK");
-        break;
-    case STAT_SYSTEM_ERROR:
-        return tr("System error");
-        break;
-    case STAT_MRNET_ERROR:
-        return tr("MRNet error");
-        break;
-    case STAT_FILTERLOAD_ERROR:
-        return tr("FilterLoad error");
-        break;
-    case STAT_GRAPHLIB_ERROR:
-        return tr("GraphLib error");
-        break;
-    case STAT_ALLOCATE_ERROR:
-        return tr("Allocate error");
-        break;
-    case STAT_ATTACH_ERROR:
-        return tr("Attach error");
-        break;
-    case STAT_DETACH_ERROR:
-        return tr("Detach error");
-        break;
-    case STAT_SEND_ERROR:
-        return tr("Send error");
-        break;
-    case STAT_SAMPLE_ERROR:
-        return tr("Sample error");
-        break;
-    case STAT_TERMINATE_ERROR:
-        return tr("Terminate error");
-        break;
-    case STAT_FILE_ERROR:
-        return tr("File error");
-        break;
-    case STAT_LMON_ERROR:
-        return tr("LaunchMON error");
-        break;
-    case STAT_ARG_ERROR:
-        return tr("ARG error");
-        break;
-    case STAT_VERSION_ERROR:
-        return tr("Version error");
-        break;
-    case STAT_NOT_LAUNCHED_ERROR:
-        return tr("NotLaunched error");
-        break;
-    case STAT_NOT_ATTACHED_ERROR:
-        return tr("NotAttached error");
-        break;
-    case STAT_NOT_CONNECTED_ERROR:
-        return tr("NotConnected error");
-        break;
-    case STAT_NO_SAMPLES_ERROR:
-        return tr("NoSamples error");
-        break;
-    case STAT_WARNING:
-        return tr("Warning error");
-        break;
-    case STAT_LOG_MESSAGE:
-        return tr("LogMessage Error");
-        break;
-    case STAT_STDOUT:
-        return tr("StdOut error");
-        break;
-    case STAT_VERBOSITY:
-        return tr("Verbosity error");
-        break;
-    case STAT_STACKWALKER_ERROR:
-        return tr("Stackwalker error");
-        break;
-    case STAT_PAUSE_ERROR:
-        return tr("Pause error");
-        break;
-    case STAT_RESUME_ERROR:
-        return tr("Resume error");
-        break;
-    case STAT_DAEMON_ERROR:
-        return tr("Daemon error");
-        break;
-    case STAT_APPLICATION_EXITED:
-        return tr("ApplicationExited error");
-        break;
-    case STAT_PENDING_ACK:
-        return tr("PendingAck error");
-        break;
-    default:
-        return tr("Unknown error");
-        break;
+    if(!m_StartupReported) {
+        m_StartupReported = true;
+        emit phaseTimed("Adapter Startup", m_StartupTime, QUuid());
     }
-}
-
-const QString &CompiledAdapter::defaultFilterPath() const
-{
-    return m_DefaultFilterPath;
-}
 
-const QString &CompiledAdapter::defaultToolDaemonPath() const
-{
-    return m_DefaultToolDaemonPath;
-}
-const QString &CompiledAdapter::installPath() const
-{
-    return m_InstallPath;
-}
-const QString &CompiledAdapter::outputPath() const
-{
-    return m_OutputPath;
+    QMutexLocker locker(&m_DefaultsLock);
+    if(m_DefaultsResolved && !m_DefaultsReported) {
+        m_DefaultsReported = true;
+        qint64 defaultsTime = m_DefaultsTime;
+        locker.unlock();
+        emit phaseTimed("Resolve Front End Defaults", defaultsTime, QUuid());
+    }
 }
 
 void CompiledAdapter::cancel(const QUuid &id)
@@ -843,7 +352,23 @@ void CompiledAdapter::cancel(const QUuid &id)
     emit progressMessage(tr("Canceling"), id);
     emit progress(99, id);
 
-    //TODO: cancel operation
+    // Released and unknown jobs have nothing running; this is a slot, so don't throw
+    Session *session = m_Sessions.value(id, NULL);
+    if(!session) {
+        emit canceled(id);
+        emit progressMessage(tr("Canceled"), id);
+        emit progress(100, id);
+        return;
+    }
+
+    // Anything still queued for this session is dropped outright.  The operation handed to a worker, if any, is
+    // canceled even if it hasn't begun; the session emits canceled() once its worker has unwound and torn the
+    // FrontEnd down.
+    bool active = false;
+    m_Scheduler.cancel(session, &active);
+    if(active) {
+        return;
+    }
 
     emit canceled(id);
     emit progressMessage(tr("Canceled"), id);
@@ -32,32 +32,16 @@
 #include <QtCore>
 #include <QtGui>
 
-#include <STAT_FrontEnd.h>
 #include <SWAT/ConnectionManager/IAdapter.h>
 
+#include "SessionScheduler.h"
+#include "TopologyPlanner.h"
+
 
 namespace Plugins {
 namespace CompiledAdapter {
 
-// Only way to get a calling thread to sleep using Qt4.
-class Thread : public QThread
-{
-public:
-    static void sleep(unsigned long msecs)
-    {
-        if(msecs < 100) {
-            QThread::msleep(msecs);
-        } else {
-            QTime time = QTime::currentTime();
-            time.start();
-            while((unsigned long)time.elapsed() < msecs) {
-                QApplication::processEvents();
-                int remain = msecs - time.elapsed();
-                QThread::msleep((remain <= 10) ? remain : 10);
-            }
-        }
-    }
-};
+class Session;
 
 class CompiledAdapter : public Plugins::SWAT::IAdapter
 {
@@ -71,7 +55,7 @@ public:
     QUuid launch(const LaunchOptions &options);
     QUuid attach(const AttachOptions &options);
     void reAttach(const QUuid &id);
-    void detach(const QUuid &id);
+    void detach(const QUuid &id, const DetachOptions &options = DetachOptions());
     void pause(const QUuid &id);
     void resume(const QUuid &id);
     void sample(const SampleOptions &options, const QUuid &id);
@@ -82,60 +66,46 @@ public:
     const QString &installPath() const;
     const QString &outputPath() const;
 
+    SessionScheduler &scheduler();
+
 public slots:
     void cancel(const QUuid &id);
 
 protected:
-    struct OperationProgress {
-        OperationProgress(float value = 0, float scale = 1) { this->value = value; this->scale = scale; }
-        float value;
-        float scale;
-    };
-
-    void launch(const LaunchOptions &options, const QUuid &id);
-    void attach(const AttachOptions &options, const QUuid &id);
-    STAT_FrontEnd *setupFrontEnd(const Options &options, const QUuid &id);
-    void launchMRNet(const TopologyOptions &options, const QUuid &id);
-
-    void attachApplication(const QUuid &id);
-
-    void sample(const SampleOptions &options, const QUuid &id, OperationProgress &operationProgress);
-    void sampleMultiple(const SampleOptions &options, const QUuid &id, OperationProgress &operationProgress);
+    Session *createSession(const QUuid &id);
+    Session *session(const QUuid &id);
+    void resolveDefaults() const;
 
-    void preSampleRunWait(const quint64 &runTimeWait, const QUuid &id, OperationProgress &operationProgress);
-    void sampleOne(const SampleOptions &options, const QUuid &id, OperationProgress &operationProgress);
+    virtual void connectNotify(const char *signal);
 
-
-    StatError_t waitAck(STAT_FrontEnd *frontEnd);
-
-    STAT_FrontEnd *getFrontEnd(const QUuid &id = QUuid());
-
-    QString errorToString(StatError_t error);
-
-    bool isAttached(const QUuid &id) { return m_attached.contains(id); }
-    bool isRunning(const QUuid &id)
-    {
-        if(!m_frontEnds.contains(id)) {
-            return false;
-        }
-        return getFrontEnd(id)->isRunning();
-    }
+protected slots:
+    void reportStartupTimes();
+    void sessionDetached(QUuid id);
 
 private:
-    QHash<QUuid, STAT_FrontEnd*> m_frontEnds;
-
-    QHash<QUuid, IAdapter::Options> m_reattachOptions;
-
-    //! List of attached FrontEnds; push when attaching/launching; pop when detaching
-    QList<QUuid> m_attached;
-
-    //! List of running FrontEnds; push when running; pop when else
-    QList<QUuid> m_running;
-
-    QString m_DefaultFilterPath;
-    QString m_DefaultToolDaemonPath;
-    QString m_InstallPath;
-    QString m_OutputPath;
+    //! Sessions keyed by FrontEnd ID
+    QHash<QUuid, Session*> m_Sessions;
+
+    //! Options of released sessions, kept so that they can be reattached; owned
+    QHash<QUuid, Options*> m_ReattachOptions;
+    SessionScheduler m_Scheduler;
+    TopologyPlanner m_TopologyPlanner;
+
+    //! STAT's defaults; only resolved on first use, since it takes a whole STAT_FrontEnd to read them
+    mutable QMutex m_DefaultsLock;
+    mutable bool m_DefaultsResolved;
+    mutable QString m_DefaultFilterPath;
+    mutable QString m_DefaultToolDaemonPath;
+    mutable QString m_InstallPath;
+    mutable QString m_OutputPath;
+
+    bool m_KeepOutputFiles;
+
+    //! Time taken to construct the adapter and to resolve STAT's defaults, reported once through phaseTimed()
+    qint64 m_StartupTime;
+    mutable qint64 m_DefaultsTime;
+    bool m_StartupReported;
+    bool m_DefaultsReported;
 
 };
 
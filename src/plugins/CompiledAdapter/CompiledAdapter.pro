@@ -30,10 +30,16 @@ CONFIG(debug, debug|release) {
 
 SOURCES            += CompiledAdapterPlugin.cpp \
                       CompiledAdapter.cpp \
+                      Session.cpp \
+                      SessionScheduler.cpp \
+                      TopologyPlanner.cpp \
                       FrontEnd.cpp
 
 HEADERS            += CompiledAdapterPlugin.h \
                       CompiledAdapter.h \
+                      Session.h \
+                      SessionScheduler.h \
+                      TopologyPlanner.h \
                       FrontEnd.h
 
 
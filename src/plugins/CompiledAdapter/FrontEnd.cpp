@@ -28,19 +28,345 @@
 
 #include "FrontEnd.h"
 
+#include <climits>
+
 namespace Plugins {
 namespace CompiledAdapter {
 
+/*! \brief Runs one queued verb on the FrontEnd's pool, and reports its result through a QFuture
+ */
+class FrontEndTask : public QRunnable
+{
+public:
+    FrontEndTask(FrontEnd *frontEnd, const FrontEnd::Request &request) :
+        m_FrontEnd(frontEnd),
+        m_Request(request)
+    {
+        setAutoDelete(true);
+    }
+
+    QFuture<FrontEnd::Error> start(QThreadPool *pool)
+    {
+        m_Interface.reportStarted();
+        QFuture<FrontEnd::Error> future = m_Interface.future();
+        pool->start(this);
+        return future;
+    }
+
+    void run()
+    {
+        // A canceled future only stops verbs that haven't started; STAT can't abort one under way
+        if(m_Interface.isCanceled()) {
+            m_Interface.reportFinished();
+            return;
+        }
+
+        FrontEnd::Error error = m_FrontEnd->run(m_Request);
+        m_Interface.reportFinished(&error);
+    }
+
+private:
+    FrontEnd *m_FrontEnd;
+    FrontEnd::Request m_Request;
+    QFutureInterface<FrontEnd::Error> m_Interface;
+};
+
+
+/*! \class FrontEnd
+    \brief Qt wrapper around an owned STAT_FrontEnd
+
+    The synchronous verbs throw a QString on error.  The asynchronous verbs return at once with a QFuture that
+    finishes with the verb's error code; watch it with a QFutureWatcher to continue from the GUI thread.  They are
+    run one at a time on a thread owned by this object, in the order they were queued, so a whole sequence like
+    launch, connect, attach and sample can be queued up front.  Each verb that the daemons acknowledge is sent
+    without blocking, and its thread then sleeps in a blocking receiveAck() until they do, rather than polling.
+    Launching the daemons and the MRNet tree isn't acknowledged, and connecting the tree is polled every few
+    milliseconds until STAT stops reporting it pending.
+
+    Once a queued verb fails, the verbs queued after it finish with the same error without running, until
+    clearPipelineError() is called.  Details of the failure are in lastErrorMessage().
+
+    \note Don't mix the synchronous verbs or the properties with queued verbs that haven't finished yet; STAT_FrontEnd
+          isn't thread safe.  waitForDone() blocks until the queue is empty.
+ */
+
 FrontEnd::FrontEnd(QObject *parent) :
     QObject(parent),
-    SWATFrontEnd(NULL)
+    SWATFrontEnd(new STAT_FrontEnd()),
+    m_PipelineError(Error_OK),
+    m_OwnsFrontEnd(true),
+    m_Canceled(0)
 {
+    m_Pool.setMaxThreadCount(1);
+}
+
+/*! \fn FrontEnd::FrontEnd()
+    \brief Queues verbs on a STAT_FrontEnd that the caller keeps; it is neither shut down nor deleted here
+ */
+FrontEnd::FrontEnd(STAT_FrontEnd *frontEnd, QObject *parent) :
+    QObject(parent),
+    SWATFrontEnd(frontEnd),
+    m_PipelineError(Error_OK),
+    m_OwnsFrontEnd(false),
+    m_Canceled(0)
+{
+    m_Pool.setMaxThreadCount(1);
 }
 
 FrontEnd::~FrontEnd()
 {
-    if(SWATFrontEnd) {
-        SWATFrontEnd->shutDown();
+    // Don't wait out a verb that STAT is still working on
+    cancel();
+    shutDown();
+}
+
+/*****************/
+
+/*! \fn FrontEnd::enqueue()
+    \brief Queues a verb behind the ones already queued
+ */
+QFuture<FrontEnd::Error> FrontEnd::enqueue(const Request &request)
+{
+    FrontEndTask *task = new FrontEndTask(this, request);
+    return task->start(&m_Pool);
+}
+
+/*! \fn FrontEnd::run()
+    \brief Sends a queued verb and waits for its acknowledgement; runs on the pool's thread
+ */
+FrontEnd::Error FrontEnd::run(const Request &request)
+{
+    Error error = (Error)(int)m_PipelineError;
+    if(error != Error_OK) {
+        return error;
+    }
+
+    if(m_Canceled) {
+        return Error_PendingAck;
+    }
+
+    if(!SWATFrontEnd) {
+        m_PipelineError = Error_NotLaunched;
+        return Error_NotLaunched;
+    }
+
+    StatError_t value = STAT_OK;
+    bool acknowledged = true;
+
+    switch(request.verb) {
+    case Verb_AttachAndSpawnDaemons:
+        value = SWATFrontEnd->attachAndSpawnDaemons((unsigned int)request.pid, request.remoteNode.toLocal8Bit().data());
+        acknowledged = false;
+        break;
+    case Verb_LaunchAndSpawnDaemons:
+        value = SWATFrontEnd->launchAndSpawnDaemons(request.remoteNode.toLocal8Bit().data(), request.isStatBench);
+        acknowledged = false;
+        break;
+    case Verb_LaunchMrnetTree:
+        value = SWATFrontEnd->launchMrnetTree((StatTopology_t)request.topologyType,
+                                              request.topologySpecification.toLocal8Bit().data(),
+                                              request.nodeList.toLocal8Bit().data(),
+                                              false, request.shareAppNodes, request.isStatBench);
+        acknowledged = false;
+        break;
+    case Verb_ConnectMrnetTree:
+        // Polled rather than acknowledged; STAT reports it pending until the whole tree has connected
+        while((value = SWATFrontEnd->connectMrnetTree(false, request.isStatBench)) == STAT_PENDING_ACK && !m_Canceled) {
+            pendingWait();
+        }
+        acknowledged = false;
+        break;
+    case Verb_AttachApplication:
+        value = SWATFrontEnd->attachApplication(false);
+        break;
+    case Verb_Pause:
+        value = SWATFrontEnd->pause(false);
+        break;
+    case Verb_Resume:
+        value = SWATFrontEnd->resume(false);
+        break;
+    case Verb_SampleStackTraces:
+        value = SWATFrontEnd->sampleStackTraces((StatSample_t)request.sampleType,
+                                                request.withThreads,
+                                                request.clearOnSample,
+                                                (unsigned int)request.nTraces,
+                                                (unsigned int)request.traceFrequency,
+                                                (unsigned int)request.nRetries,
+                                                (unsigned int)request.retryFrequency,
+                                                false,
+                                                request.variableSpecification.toLocal8Bit().data());
+        break;
+    case Verb_GatherLastTrace:
+        value = SWATFrontEnd->gatherLastTrace(false);
+        break;
+    case Verb_GatherTraces:
+        value = SWATFrontEnd->gatherTraces(false);
+        break;
+    case Verb_DetachApplication:
+    {
+        QVector<int> stopList = request.stopList;
+        value = SWATFrontEnd->detachApplication(stopList.isEmpty() ? NULL : stopList.data(), stopList.count(), false);
+        break;
+    }
+    }
+
+    // The verb was sent; block until the daemons acknowledge it
+    if(value == STAT_OK && acknowledged) {
+        value = SWATFrontEnd->receiveAck(true);
+    }
+
+    error = convert(value);
+    if(error != Error_OK) {
+        m_PipelineError.testAndSetOrdered(Error_OK, error);
+    }
+
+    return error;
+}
+
+QFuture<FrontEnd::Error> FrontEnd::attachAndSpawnDaemonsAsync(quint64 pid, QString remoteNode)
+{
+    Request request(Verb_AttachAndSpawnDaemons);
+    request.pid = pid;
+    request.remoteNode = remoteNode;
+    return enqueue(request);
+}
+
+QFuture<FrontEnd::Error> FrontEnd::launchAndSpawnDaemonsAsync(QString remoteNode, bool isStatBench)
+{
+    Request request(Verb_LaunchAndSpawnDaemons);
+    request.remoteNode = remoteNode;
+    request.isStatBench = isStatBench;
+    return enqueue(request);
+}
+
+QFuture<FrontEnd::Error> FrontEnd::launchMrnetTreeAsync(Topologies topologyType, QString topologySpecification,
+                                                        QString nodeList, bool shareAppNodes, bool isStatBench)
+{
+    Request request(Verb_LaunchMrnetTree);
+    request.topologyType = topologyType;
+    request.topologySpecification = topologySpecification;
+    request.nodeList = nodeList;
+    request.shareAppNodes = shareAppNodes;
+    request.isStatBench = isStatBench;
+    return enqueue(request);
+}
+
+QFuture<FrontEnd::Error> FrontEnd::connectMrnetTreeAsync(bool isStatBench)
+{
+    Request request(Verb_ConnectMrnetTree);
+    request.isStatBench = isStatBench;
+    return enqueue(request);
+}
+
+QFuture<FrontEnd::Error> FrontEnd::attachApplicationAsync()
+{
+    return enqueue(Request(Verb_AttachApplication));
+}
+
+QFuture<FrontEnd::Error> FrontEnd::pauseAsync()
+{
+    return enqueue(Request(Verb_Pause));
+}
+
+QFuture<FrontEnd::Error> FrontEnd::resumeAsync()
+{
+    return enqueue(Request(Verb_Resume));
+}
+
+QFuture<FrontEnd::Error> FrontEnd::sampleStackTracesAsync(SampleTypes sampleType,
+                                                          bool withThreads,
+                                                          bool clearOnSample,
+                                                          quint64 nTraces,
+                                                          quint64 traceFrequency,
+                                                          quint64 nRetries,
+                                                          quint64 retryFrequency,
+                                                          QString variableSpecification)
+{
+    Request request(Verb_SampleStackTraces);
+    request.sampleType = sampleType;
+    request.withThreads = withThreads;
+    request.clearOnSample = clearOnSample;
+    request.nTraces = nTraces;
+    request.traceFrequency = traceFrequency;
+    request.nRetries = nRetries;
+    request.retryFrequency = retryFrequency;
+    request.variableSpecification = variableSpecification;
+    return enqueue(request);
+}
+
+QFuture<FrontEnd::Error> FrontEnd::gatherLastTraceAsync()
+{
+    return enqueue(Request(Verb_GatherLastTrace));
+}
+
+QFuture<FrontEnd::Error> FrontEnd::gatherTracesAsync()
+{
+    return enqueue(Request(Verb_GatherTraces));
+}
+
+/*! \fn FrontEnd::detachApplicationAsync()
+    \param stopList Ranks left stopped once the rest of the application is resumed
+ */
+QFuture<FrontEnd::Error> FrontEnd::detachApplicationAsync(const QList<quint64> &stopList)
+{
+    Request request(Verb_DetachApplication);
+    foreach(quint64 rank, stopList) {
+        if(rank > (quint64)INT_MAX) {
+            throw tr("FrontEnd::detachApplicationAsync rank %1 is out of range").arg(rank);
+        }
+        request.stopList.append((int)rank);
+    }
+    return enqueue(request);
+}
+
+/*! \fn FrontEnd::pipelineError()
+    \returns Error of the first queued verb that failed, or Error_OK
+ */
+FrontEnd::Error FrontEnd::pipelineError() const
+{
+    return (Error)(int)m_PipelineError;
+}
+
+/*! \fn FrontEnd::clearPipelineError()
+    \brief Lets verbs queued after a failure run again
+ */
+void FrontEnd::clearPipelineError()
+{
+    m_PipelineError = Error_OK;
+}
+
+/*! \fn FrontEnd::waitForDone()
+    \brief Blocks until every queued verb has finished
+ */
+void FrontEnd::waitForDone()
+{
+    m_Pool.waitForDone();
+}
+
+/*! \fn FrontEnd::cancel()
+    \brief Stops the queue; may be called from any thread
+
+    A verb that is still waiting on STAT stops waiting within a few milliseconds, and it and the verbs queued after
+    it finish with Error_PendingAck.  A verb that STAT is blocked in can't be cut short.
+ */
+void FrontEnd::cancel()
+{
+    m_Canceled = 1;
+
+    QMutexLocker locker(&m_PendingMutex);
+    m_PendingCondition.wakeAll();
+}
+
+/*! \fn FrontEnd::pendingWait()
+    \brief Sleeps on the pool's thread until a pending verb is due to be polled again, or cancel() is called
+ */
+void FrontEnd::pendingWait()
+{
+    static const unsigned long interval = 5;
+
+    QMutexLocker locker(&m_PendingMutex);
+    if(!m_Canceled) {
+        m_PendingCondition.wait(&m_PendingMutex, interval);
     }
 }
 
@@ -172,7 +498,13 @@ void FrontEnd::detachApplication(qptrdiff stopList, quint64 stopListSize, bool b
 
 void FrontEnd::shutDown()
 {
-    SWATFrontEnd->shutDown();
+    // Queued verbs still use the FrontEnd
+    m_Pool.waitForDone();
+
+    if(SWATFrontEnd && m_OwnsFrontEnd) {
+        SWATFrontEnd->shutDown();
+        delete SWATFrontEnd;
+    }
     SWATFrontEnd = NULL;
 }
 
@@ -320,24 +652,35 @@ QString FrontEnd::installPrefix() const
     return QString(SWATFrontEnd->getInstallPrefix());
 }
 
-int FrontEnd::version()
+/*! \fn FrontEnd::version()
+    \returns STAT's version, as "major.minor.revision"
+ */
+QString FrontEnd::version() const
 {
-    int *value = NULL;
+    // STAT fills in an array of three
+    int value[3] = { 0, 0, 0 };
     SWATFrontEnd->getVersion(value);
 
-    int version = *value;
-    return version;
+    return QString("%1.%2.%3").arg(value[0]).arg(value[1]).arg(value[2]);
 }
 
 /**********/
 
 
-FrontEnd::Error FrontEnd::convert(StatError_t error)
+/*! \fn FrontEnd::errorString()
+    \returns Readable name of an error code, such as the result of an asynchronous verb
+ */
+QString FrontEnd::errorString(Error error) const
+{
+    return convert(error);
+}
+
+FrontEnd::Error FrontEnd::convert(StatError_t error) const
 {
     return (Error)error;
 }
 
-QString FrontEnd::convert(Error error)
+QString FrontEnd::convert(Error error) const
 {
     switch(error) {
     case Error_OK:
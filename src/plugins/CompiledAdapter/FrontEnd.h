@@ -36,6 +36,8 @@
 namespace Plugins {
 namespace CompiledAdapter {
 
+class FrontEndTask;
+
 class FrontEnd : public QObject
 {
     Q_OBJECT
@@ -103,9 +105,48 @@ public:
         Error_PendingAck
     };
 
+    //! Verbs that can be queued with the asynchronous interface
+    enum Verb {
+        Verb_AttachAndSpawnDaemons,
+        Verb_LaunchAndSpawnDaemons,
+        Verb_LaunchMrnetTree,
+        Verb_ConnectMrnetTree,
+        Verb_AttachApplication,
+        Verb_Pause,
+        Verb_Resume,
+        Verb_SampleStackTraces,
+        Verb_GatherLastTrace,
+        Verb_GatherTraces,
+        Verb_DetachApplication
+    };
+
     explicit FrontEnd(QObject *parent = 0);
+    explicit FrontEnd(STAT_FrontEnd *frontEnd, QObject *parent = 0);
     ~FrontEnd();
 
+    /* START Asynchronous Verbs */
+    QFuture<Error> attachAndSpawnDaemonsAsync(quint64 pid, QString remoteNode = QString());
+    QFuture<Error> launchAndSpawnDaemonsAsync(QString remoteNode = QString(), bool isStatBench = false);
+    QFuture<Error> launchMrnetTreeAsync(Topologies topologyType, QString topologySpecification,
+                                        QString nodeList = QString(), bool shareAppNodes = false,
+                                        bool isStatBench = false);
+    QFuture<Error> connectMrnetTreeAsync(bool isStatBench = false);
+    QFuture<Error> attachApplicationAsync();
+    QFuture<Error> pauseAsync();
+    QFuture<Error> resumeAsync();
+    QFuture<Error> sampleStackTracesAsync(SampleTypes sampleType, bool withThreads, bool clearOnSample, quint64 nTraces,
+                                          quint64 traceFrequency, quint64 nRetries, quint64 retryFrequency,
+                                          QString variableSpecification = QString());
+    QFuture<Error> gatherLastTraceAsync();
+    QFuture<Error> gatherTracesAsync();
+    QFuture<Error> detachApplicationAsync(const QList<quint64> &stopList = QList<quint64>());
+
+    Error pipelineError() const;
+    void clearPipelineError();
+    void waitForDone();
+    void cancel();
+    /* END Asynchronous Verbs */
+
     /* START Verbs */
     void attachAndSpawnDaemons(quint64 pid, QString remoteNode = QString());
     void launchAndSpawnDaemons(QString remoteNode = QString(), bool isStatBench = false);
@@ -159,19 +200,67 @@ public:
     QString lastDotFilename() const;
     QString applExe() const;
     QString installPrefix() const;
-    int version();
+    QString version() const;
     /* END Properties */
 
+    QString errorString(Error error) const;
+
 signals:
 
 public slots:
 
 protected:
+    //! Arguments of a queued verb; only the ones the verb takes are filled in
+    struct Request {
+        explicit Request(Verb verb) : verb(verb), pid(0), isStatBench(false), topologyType(Topology_Auto),
+            shareAppNodes(false), sampleType(Sample_FunctionNameOnly), withThreads(false), clearOnSample(true),
+            nTraces(1), traceFrequency(0), nRetries(0), retryFrequency(0) {}
+
+        Verb verb;
+        quint64 pid;
+        QString remoteNode;
+        bool isStatBench;
+        Topologies topologyType;
+        QString topologySpecification;
+        QString nodeList;
+        bool shareAppNodes;
+        SampleTypes sampleType;
+        bool withThreads;
+        bool clearOnSample;
+        quint64 nTraces;
+        quint64 traceFrequency;
+        quint64 nRetries;
+        quint64 retryFrequency;
+        QString variableSpecification;
+        QVector<int> stopList;
+    };
+
+    QFuture<Error> enqueue(const Request &request);
+    Error run(const Request &request);
+
+    void pendingWait();
+
     STAT_FrontEnd *SWATFrontEnd;
 
-    Error convert(StatError_t error);
-    QString convert(Error error);
+    Error convert(StatError_t error) const;
+    QString convert(Error error) const;
+
+private:
+    //! Runs the queued verbs one at a time, in the order they were queued
+    QThreadPool m_Pool;
+
+    //! First error of the queued verbs; the verbs queued after it report it again without running
+    QAtomicInt m_PipelineError;
+
+    //! False if the STAT_FrontEnd was handed in by the caller, who keeps it
+    bool m_OwnsFrontEnd;
+
+    //! Set by cancel(); cuts short a verb that is waiting on STAT, and keeps the rest of the queue from running
+    QAtomicInt m_Canceled;
+    QMutex m_PendingMutex;
+    QWaitCondition m_PendingCondition;
 
+    friend class FrontEndTask;
 };
 
 } // namespace CompiledAdapter
@@ -0,0 +1,1649 @@
+/*!
+   \file Session.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "Session.h"
+
+#include "FrontEnd.h"
+
+#include <SWAT/DirectedGraph/DotRewriter.h>
+
+#include <climits>
+
+#ifdef COMPILEDADAPTER_DEBUG
+#  include <QtDebug>
+#endif
+
+using namespace Plugins::SWAT;
+
+namespace Plugins {
+namespace CompiledAdapter {
+
+static bool removeFile(QString filename)
+{
+    return QFile::remove(filename);
+}
+
+//! Serializes FrontEnd setup; the environment it sets is process wide, and sessions are set up on several threads
+static QMutex setupMutex;
+
+/*! \brief Blocks in STAT_FrontEnd::receiveAck() on the session's acknowledgement thread, and wakes the worker
+ */
+class AckReceiver : public QRunnable
+{
+public:
+    AckReceiver(Session *session, STAT_FrontEnd *frontEnd) : m_Session(session), m_FrontEnd(frontEnd)
+    {
+        setAutoDelete(true);
+    }
+
+    void run()
+    {
+        m_Session->receiveAck(m_FrontEnd);
+    }
+
+private:
+    Session *m_Session;
+    STAT_FrontEnd *m_FrontEnd;
+};
+
+/*! \class Session
+    \version 0.1.dev
+    \brief Owns a single STAT_FrontEnd and runs its operations
+
+    Operations are run on worker threads by the SessionScheduler, one at a time per session, so they never block
+    the GUI thread.  All feedback is reported through signals that mirror the IAdapter signals.
+
+    An operation in flight can be abandoned with cancel(), from any thread.  The request is checked between
+    phases and inside every acknowledgement wait; the FrontEnd is then shut down and canceled() is emitted.
+ */
+
+Session::Session(const QUuid &id, QObject *parent) :
+    QObject(parent),
+    m_Id(id),
+    m_FrontEnd(NULL),
+    m_Attached(false),
+    m_ToolsRunning(false),
+    m_KeepOutputFiles(1),
+    m_TopologyPlanner(NULL),
+    m_ReattachOptions(NULL),
+    m_AckWakeups(0),
+    m_AckReceived(false),
+    m_AckResult(STAT_OK),
+    m_OperationAckWakeups(0),
+    m_OperationAckTime(0),
+    m_LastAckWakeups(0),
+    m_Busy(false),
+    m_PendingCancel(false),
+    m_QueueWaitTime(-1),
+    m_Pipeline(NULL),
+    m_LastStoppedTime(0),
+    m_Phase(NULL)
+{
+    m_AckPool.setMaxThreadCount(1);
+}
+
+Session::~Session()
+{
+    shutDown();
+
+    if(m_ReattachOptions) {
+        delete m_ReattachOptions;
+        m_ReattachOptions = NULL;
+    }
+}
+
+const QUuid &Session::id() const
+{
+    return m_Id;
+}
+
+void Session::launch(const IAdapter::LaunchOptions &options)
+{
+    beginOperation();
+
+    try {
+
+        StatError_t statError;
+
+        emit launching(m_Id);
+        emit progress(1, m_Id);
+
+        beginPhase("Starting Front End");
+        emit progressMessage("Starting Front End", m_Id);
+        STAT_FrontEnd *frontEnd = setupFrontEnd(options);
+
+        if(m_ReattachOptions) {
+            delete m_ReattachOptions;
+        }
+        m_ReattachOptions = new IAdapter::LaunchOptions(options);  // Save for possible later reattach
+
+        m_Cancellation.check();
+
+//        options.args.pop_front();  // STATGUI.py just ignores the 'Launcher Exe' argument
+        foreach(QString arg, options.args) {
+            frontEnd->addLauncherArgv(arg.toLocal8Bit().data());
+        }
+        emit progress(5, m_Id);
+
+#ifdef COMPILEDADAPTER_DEBUG
+        Thread::sleep(100);
+        qDebug() << "STAT_FrontEnd::launchAndSpawnDaemons()";
+        Thread::sleep(100);
+#endif
+        beginPhase("Launch Daemons");
+        emit progressMessage("Launch Daemons", m_Id);
+        if(options.remoteHost == "localhost") {
+            statError = frontEnd->launchAndSpawnDaemons();
+        } else {
+            statError = frontEnd->launchAndSpawnDaemons(options.remoteHost.toLocal8Bit().data());
+        }
+        if(statError != STAT_OK) {
+            throw tr("Failed to launch daemons: %1").arg(frontEnd->getLastErrorMessage());
+        }
+        emit progress(10, m_Id);
+
+        m_Cancellation.check();
+
+#ifdef COMPILEDADAPTER_DEBUG
+        Thread::sleep(100);
+        qDebug() << "Session::launchMRNet()";
+        Thread::sleep(100);
+#endif
+        emit progressMessage("Connect to Daemons", m_Id);
+        launchMRNet(options, m_Cancellation);
+        m_ToolsRunning = true;
+        emit progress(15, m_Id);
+
+#ifdef COMPILEDADAPTER_DEBUG
+        Thread::sleep(100);
+        qDebug() << "Session::attachApplication()";
+        Thread::sleep(100);
+#endif
+        beginPhase("Attach to Application");
+        emit progressMessage("Attach to Application", m_Id);
+        attachApplication(m_Cancellation);
+        emit progress(20, m_Id);
+
+        IAdapter::LaunchOptions launchOptions = options;
+        launchOptions.traceCount = 1;
+        launchOptions.traceFrequency = 1;
+
+        OperationProgress operationProgress(30, 0.7);
+        sample(launchOptions, operationProgress, m_Cancellation);
+        emit progress(100, m_Id);
+
+        m_Attached = true;
+        emit launched(m_Id);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit failed(tr("Error while launching: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while launching."), m_Id);
+    }
+
+    endOperation();
+}
+
+void Session::attach(const IAdapter::AttachOptions &options)
+{
+    beginOperation();
+
+    try {
+
+        StatError_t statError;
+
+        emit attaching(m_Id);
+
+        beginPhase("Starting Front End");
+        emit progressMessage("Starting Front End", m_Id);
+        STAT_FrontEnd *frontEnd = setupFrontEnd(options);
+
+        if(m_ReattachOptions) {
+            delete m_ReattachOptions;
+        }
+        m_ReattachOptions = new IAdapter::AttachOptions(options);  // Save for possible later reattach
+
+        m_Cancellation.check();
+
+        emit progress(5, m_Id);
+
+        beginPhase("Launch Daemons");
+        emit progressMessage("Launch Daemons", m_Id);
+        if(options.remoteHost == "localhost") {
+            statError = frontEnd->attachAndSpawnDaemons(options.pid);
+        } else {
+            statError = frontEnd->attachAndSpawnDaemons(options.pid, options.remoteHost.toLocal8Bit().data());
+        }
+        if(statError != STAT_OK) {
+            throw tr("Failed to launch daemons: %1").arg(frontEnd->getLastErrorMessage());
+        }
+        emit progress(10, m_Id);
+
+        m_Cancellation.check();
+
+        emit progressMessage("Connect to Daemons", m_Id);
+        launchMRNet(options, m_Cancellation);
+        m_ToolsRunning = true;
+        emit progress(15, m_Id);
+
+        beginPhase("Attach to Application");
+        emit progressMessage("Attach to Application", m_Id);
+        attachApplication(m_Cancellation);
+        emit progress(20, m_Id);
+
+        IAdapter::AttachOptions attachOptions = options;
+        attachOptions.traceCount = 1;
+        attachOptions.traceFrequency = 1;
+
+        OperationProgress operationProgress(30, 0.7);
+        sample(attachOptions, operationProgress, m_Cancellation);
+        emit progress(100, m_Id);
+
+        m_Attached = true;
+        emit attached(m_Id);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit failed(tr("Error while attaching: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while attaching."), m_Id);
+    }
+
+    endOperation();
+}
+
+STAT_FrontEnd *Session::setupFrontEnd(const IAdapter::Options &options)
+{
+    QMutexLocker locker(&setupMutex);
+
+    StatError_t statError;
+    STAT_FrontEnd *frontEnd = this->frontEnd();
+
+    statError = frontEnd->setToolDaemonExe(options.toolDaemonPath.toLocal8Bit().data());
+    if(statError != STAT_OK) {
+        throw tr("STAT_FrontEnd::setToolDaemonExe() returned error: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    statError = frontEnd->setFilterPath(options.filterPath.toLocal8Bit().data());
+    if(statError != STAT_OK) {
+        throw tr("STAT_FrontEnd::setFilterPath() returned error: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    if(options.logFlags > 0) {
+        StatLog_t logType = STAT_LOG_NONE;
+        if(options.logFlags | IAdapter::Log_FrontEnd && options.logFlags | IAdapter::Log_BackEnd) {
+            logType = STAT_LOG_ALL;
+        } else if(options.logFlags | IAdapter::Log_FrontEnd) {
+            logType = STAT_LOG_FE;
+        } else if(options.logFlags | IAdapter::Log_BackEnd) {
+            logType = STAT_LOG_BE;
+        }
+
+        statError = frontEnd->startLog(logType, options.logPath.toLocal8Bit().data());
+        if(statError != STAT_OK) {
+            throw tr("Failed to start log: %1").arg(frontEnd->getLastErrorMessage());
+        }
+    }
+
+    if(options.verboseFlags | IAdapter::Verbose_Error && options.verboseFlags | IAdapter::Verbose_StdOut) {
+        frontEnd->setVerbose(STAT_VERBOSE_FULL);
+    } else if(options.verboseFlags | IAdapter::Verbose_Error) {
+        frontEnd->setVerbose(STAT_VERBOSE_ERROR);
+    } else if(options.verboseFlags | IAdapter::Verbose_StdOut) {
+        frontEnd->setVerbose(STAT_VERBOSE_STDOUT);
+    }
+
+    if(options.debugFlags & IAdapter::Debug_BackEnd) {
+        qputenv("LMON_DEBUG_BES", "1");
+    } else {
+        // Clear the environment variable (unsetenv is not compatible with MinGW or MSVC)
+        //NOTE: this _may_ fail on some systems (AIX?)
+        qputenv("LMON_DEBUG_BES", QByteArray());
+    }
+
+    frontEnd->setProcsPerNode(options.processesPerNode);
+
+    return frontEnd;
+}
+
+void Session::reAttach()
+{
+    try {
+
+        if(isAttached()) {
+            throw tr("Unable to reattach; already attached!");
+        }
+
+        if(!m_ReattachOptions) {
+            throw tr("Unable to reattach; options not found in cache.");
+        }
+
+        // The daemons and tree were left up by the detach; only the application needs to be reattached
+        if(m_ToolsRunning && reAttachApplication()) {
+            return;
+        }
+
+        IAdapter::AttachOptions *attachOptions = dynamic_cast<IAdapter::AttachOptions*>(m_ReattachOptions);
+        if(attachOptions) {
+            attach(IAdapter::AttachOptions(*attachOptions));
+            return;
+        }
+
+        IAdapter::LaunchOptions *launchOptions = dynamic_cast<IAdapter::LaunchOptions*>(m_ReattachOptions);
+        if(launchOptions) {
+            launch(IAdapter::LaunchOptions(*launchOptions));
+            return;
+        }
+
+        throw tr("Unable to reattach; valid options not found in cache.");
+
+    } catch(QString err) {
+        emit failed(tr("Error while reattaching: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while reattaching."), m_Id);
+    }
+}
+
+void Session::detach(const IAdapter::DetachOptions &options)
+{
+    beginOperation();
+
+    try {
+
+        if(!m_FrontEnd) {
+            throw tr("Session::detach() frontEnd was null! This is not a valid value.");
+        }
+
+        STAT_FrontEnd *frontEnd = this->frontEnd();
+
+        StatError_t statError;
+
+        if(!isAttached()) {
+            // Already detached, but with the tools kept running; all that's left is to shut them down
+            if(m_ToolsRunning && !options.keepToolsRunning) {
+                emit detaching(m_Id);
+                beginPhase("Shut Down Tools");
+                shutDown();
+                emit detached(m_Id);
+                endOperation();
+                return;
+            }
+
+            throw tr("Unable to detach; not already attached.");
+        }
+
+        // STAT takes the ranks to leave stopped as ints
+        QVector<int> stopList;
+        stopList.reserve(options.stopList.count());
+        foreach(quint64 rank, options.stopList) {
+            if(rank > (quint64)INT_MAX) {
+                throw tr("Unable to leave rank %1 stopped; it is out of range.").arg(rank);
+            }
+            stopList.append((int)rank);
+        }
+
+        emit detaching(m_Id);
+        beginPhase("Detach Application");
+
+        if((statError = frontEnd->detachApplication(stopList.isEmpty() ? NULL : stopList.data(),
+                                                    stopList.count(), false)) != STAT_OK) {
+            throw tr("Failed to detach from application: %1").arg(frontEnd->getLastErrorMessage());
+        }
+
+        if((statError = waitAck(frontEnd, m_Cancellation)) != STAT_OK) {
+            throw tr("Failed to resume application: %1").arg(frontEnd->getLastErrorMessage());
+        }
+
+        if(!stopList.isEmpty()) {
+            emit progressMessage(tr("Left %n rank(s) stopped", 0, stopList.count()), m_Id);
+        }
+
+        if(options.keepToolsRunning) {
+            m_Attached = false;
+        } else {
+            shutDown();
+        }
+
+        emit detached(m_Id);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit failed(tr("Error while detaching: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while detaching."), m_Id);
+    }
+
+    endOperation();
+}
+
+void Session::pause()
+{
+    beginOperation();
+
+    try {
+
+        if(!m_FrontEnd) {
+            throw tr("Session::pause() frontEnd was null! This is not a valid value.");
+        }
+
+        STAT_FrontEnd *frontEnd = this->frontEnd();
+
+        StatError_t statError;
+
+        // Nothing to pause if we're not running; fall through so that the operation still ends
+        if(frontEnd->isRunning()) {
+            emit pausing(m_Id);
+            beginPhase("Pause Application");
+
+            if((statError = frontEnd->pause()) != STAT_OK) {
+                throw tr("Failed to pause application: %1").arg(frontEnd->getLastErrorMessage());
+            }
+
+            if((statError = waitAck(frontEnd, m_Cancellation)) != STAT_OK) {
+                throw tr("Failed to pause application: %1").arg(frontEnd->getLastErrorMessage());
+            }
+        }
+
+        emit paused(m_Id);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit failed(tr("Error while pausing: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while pausing."), m_Id);
+    }
+
+    endOperation();
+}
+
+void Session::resume()
+{
+    beginOperation();
+
+    try {
+
+        resumeApplication(m_Cancellation);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit failed(tr("Error while resuming: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while resuming."), m_Id);
+    }
+
+    endOperation();
+}
+
+/*! \fn Session::resumeApplication()
+    \brief Resumes the application, if it isn't already running
+    \param cancellation Token checked while waiting for the daemons
+ */
+void Session::resumeApplication(const CancellationToken &cancellation)
+{
+    //TODO: Should we just reattach if possible?
+    if(!m_FrontEnd) {
+        throw tr("Session::resume() frontEnd was null! This is not a valid value.");
+    }
+
+    STAT_FrontEnd *frontEnd = this->frontEnd();
+
+    StatError_t statError;
+
+    // Can't resume if we're already running
+    if(frontEnd->isRunning()) {
+        return;
+    }
+
+    emit resuming(m_Id);
+    beginPhase("Resume Application");
+
+    if((statError = frontEnd->resume()) != STAT_OK) {
+        throw tr("Failed to resume application: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    if((statError = waitAck(frontEnd, cancellation)) != STAT_OK) {
+        throw tr("Failed to resume application: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    emit resumed(m_Id);
+}
+
+void Session::sample(const IAdapter::SampleOptions &options)
+{
+    beginOperation();
+
+    try {
+
+        OperationProgress operationProgress;
+        sample(options, operationProgress, m_Cancellation);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit failed(tr("Error while sampling: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while sampling."), m_Id);
+    }
+
+    endOperation();
+}
+
+void Session::sample(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                     const CancellationToken &cancellation)
+{
+    if(!m_FrontEnd) {
+        throw tr("Session::sample() frontEnd was null! This is not a valid value.");
+    }
+
+    // Store the progress scale, we're going to be messing with it for sub-operations
+    float operationProgressScale = operationProgress.scale;
+
+    // Run the application for the specified period before we begin
+    operationProgress.scale = 0.05 * operationProgressScale;  // (((our steps) * (our scale)) / (sub-op scale))
+    preSampleRunWait(options.runTimeBeforeSample, operationProgress, cancellation);
+
+
+    // Rescale the progress for the following operations
+    operationProgress.scale = 0.85 * operationProgressScale;
+
+    IAdapter::SampleOptions sampleOneOptions = options;
+    sampleOneOptions.traceCount = 1;
+    sampleOneOptions.traceFrequency = 1;
+
+    sampleOne(sampleOneOptions, operationProgress, cancellation);
+}
+
+void Session::sampleMultiple(const IAdapter::SampleOptions &options)
+{
+    beginOperation();
+
+    try {
+
+        OperationProgress operationProgress;
+        sampleMultiple(options, operationProgress, m_Cancellation);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit failed(tr("Error while multi-sampling: %1").arg(err), m_Id);
+    } catch(...) {
+        emit failed(tr("Error while multi-sampling."), m_Id);
+    }
+
+    endOperation();
+}
+
+void Session::sampleMultiple(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                             const CancellationToken &cancellation)
+{
+    if(!m_FrontEnd) {
+        throw tr("Session::sampleMultiple() frontEnd was null! This is not a valid value.");
+    }
+
+    StatError_t statError;
+
+    // Store the progress scale, we're going to be messing with it for sub-operations
+    float operationProgressScale = operationProgress.scale;
+
+    // Run the application for the specified period before we begin
+    operationProgress.scale = 0.05 * operationProgressScale;  // (((our steps) * (our scale)) / (sub-op scale))
+    preSampleRunWait(options.runTimeBeforeSample, operationProgress, cancellation);
+
+    STAT_FrontEnd *frontEnd = this->frontEnd();
+
+    if(options.perturbationBudget > 0) {
+        // Rescale the progress for the following operations
+        operationProgress.scale = 0.85 * operationProgressScale / options.traceCount;
+        sampleAdaptive(options, operationProgress, cancellation);
+
+    } else if(options.gatherIndividualSamples) {
+        // Rescale the progress for the following operations
+        operationProgress.scale = 0.85 * operationProgressScale / options.traceCount;
+
+        IAdapter::SampleOptions tempOptions = options;
+        tempOptions.traceCount = 1;
+        tempOptions.traceFrequency = 0;
+        for(quint64 i=0; i < options.traceCount; ++i) {
+            if(i == 1) tempOptions.clearOnSample = false;
+            sampleOne(tempOptions, operationProgress, cancellation);
+        }
+
+    } else {
+        // Let the daemons take every trace in one request; skips the per-trace gather and render round trips
+        operationProgress.scale = 0.85 * operationProgressScale;
+        sampleBatch(options, operationProgress, cancellation);
+
+    }
+
+
+    cancellation.check();
+
+    beginPhase("Gather Stack Traces");
+    emit progressMessage("Gather Stack Traces", m_Id);
+    if((statError = frontEnd->gatherTraces(false)) != STAT_OK) {
+        throw tr("Failed to gather stack traces:\n%1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    if((statError = waitAck(frontEnd, cancellation)) != STAT_OK) {
+        throw tr("Failed to gather stack traces: %1").arg(frontEnd->getLastErrorMessage());
+    }
+    recordGather();
+    operationProgress.value += operationProgressScale * 5;
+    emit progress(operationProgress.value, m_Id);
+
+    beginPhase("Render Stack Traces");
+    emit progressMessage("Render Stack Traces", m_Id);
+    renderSample(frontEnd->getLastDotFilename(), options.ranks);
+
+    operationProgress.value += operationProgressScale * 43;
+    emit progress(operationProgress.value, m_Id);
+}
+
+/*! \fn Session::preSampleRunWait()
+    \brief Helper function for sample operations where a required wait period occurs
+    \param runTimeWait time in seconds to run the application before returning
+    \param operationProgress
+    \param cancellation Token checked while waiting
+ */
+void Session::preSampleRunWait(const quint64 &runTimeWait, OperationProgress &operationProgress,
+                               const CancellationToken &cancellation)
+{
+    float operationProgressValue = operationProgress.value;
+
+    if(runTimeWait > 0) {
+        beginPhase("Pre-Sample Run Time");
+        if(!isRunning()) {
+            resumeApplication(cancellation);
+        }
+
+        emit progressMessage("Waiting for Pre-Sample Run Time", m_Id);
+
+        static const int progressSteps = 10;
+        const qint64 runTime = (qint64)runTimeWait * 1000;
+
+        // Measured on the monotonic clock, so wall clock changes and midnight don't affect the wait
+        QElapsedTimer runTimer;
+        runTimer.start();
+
+        // The worker only wakes to report progress, or when the operation is canceled
+        for(int step = 1; step <= progressSteps; ++step) {
+            waitUntil(runTimer, (runTime * step) / progressSteps, cancellation);
+            operationProgress.value += operationProgress.scale * (100 / progressSteps);
+            emit progress(operationProgress.value, m_Id);
+        }
+    }
+
+    // Ensure that we always finish at 100% for this operation
+    operationProgress.value = operationProgressValue + operationProgress.scale * 100;
+    emit progress(operationProgress.value, m_Id);
+}
+
+/*! \fn Session::sampleAdaptive()
+    \brief Takes the requested traces one at a time, spacing them to stay within the perturbation budget
+    \param options Sample options; traceFrequency is the shortest interval allowed between samples
+    \param operationProgress
+    \param cancellation Token checked between samples and while waiting for the next one
+
+    Each trace is taken as a non-stop sample, and the time it kept the application stopped is measured.  The
+    interval to the next sample is then the smoothed stopped time divided by the budget, so that with a 1%
+    budget a sample that stops the application for 50 ms is followed by a 5 s interval.  The interval never
+    drops below the time the sample (and its gather, when gathering individually) took.  Each chosen interval
+    is reported as a progress message and timed as the "Adaptive Sample Interval" phase.
+ */
+void Session::sampleAdaptive(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                             const CancellationToken &cancellation)
+{
+    // The stopped time only means something if the application runs between samples
+    if(!isRunning()) {
+        resumeApplication(cancellation);
+    }
+
+    IAdapter::SampleOptions tempOptions = options;
+    tempOptions.traceCount = 1;
+    tempOptions.traceFrequency = 0;
+    tempOptions.nonStop = true;
+
+    const double budget = qMin(options.perturbationBudget, 1.0);
+    double expectedStoppedTime = -1;
+    qint64 totalStoppedTime = 0;
+
+    QElapsedTimer wallTime;
+    wallTime.start();
+
+    for(quint64 i = 0; i < options.traceCount; ++i) {
+        if(i == 1) tempOptions.clearOnSample = false;
+
+        QElapsedTimer sampleTime;
+        sampleTime.start();
+
+        m_LastStoppedTime = 0;
+        if(options.gatherIndividualSamples) {
+            sampleOne(tempOptions, operationProgress, cancellation);
+        } else {
+            sampleBatch(tempOptions, operationProgress, cancellation);
+        }
+        qint64 cost = sampleTime.elapsed();
+        totalStoppedTime += m_LastStoppedTime;
+
+        // Smooth the stopped time, so a single slow sample doesn't stretch the rest of the schedule
+        if(expectedStoppedTime < 0) {
+            expectedStoppedTime = m_LastStoppedTime;
+        } else {
+            expectedStoppedTime = (expectedStoppedTime + m_LastStoppedTime) / 2;
+        }
+
+        if(i + 1 >= options.traceCount) {
+            break;
+        }
+
+        qint64 interval = (qint64)qCeil(expectedStoppedTime / budget);
+        interval = qMax(interval, qMax(cost, (qint64)options.traceFrequency));
+
+        beginPhase("Adaptive Sample Interval");
+        emit progressMessage(tr("Sample %1 of %2 stopped the application for %3 ms; next sample in %4 ms")
+                             .arg(i + 1).arg(options.traceCount).arg(m_LastStoppedTime).arg(interval), m_Id);
+
+#ifdef COMPILEDADAPTER_DEBUG
+        qDebug() << m_Id.toString() << "adaptive sample" << i + 1 << "stopped" << m_LastStoppedTime << "ms; cost"
+                 << cost << "ms; interval" << interval << "ms";
+#endif
+
+        waitUntil(sampleTime, interval, cancellation);
+    }
+
+    qint64 elapsed = qMax(wallTime.elapsed(), (qint64)1);
+    emit progressMessage(tr("Application was stopped for %1% of %2 s (budget %3%)")
+                         .arg(100.0 * totalStoppedTime / elapsed, 0, 'f', 2)
+                         .arg(elapsed / 1000.0, 0, 'f', 1)
+                         .arg(100.0 * budget, 0, 'f', 2), m_Id);
+}
+
+/*! \fn Session::sampleBatch()
+    \brief Samples all of the requested traces with a single request to the daemons
+    \note The traces are left on the daemons; the caller is expected to gather them
+    \param options Sample options; the trace count and frequency are passed through as they are
+    \param operationProgress
+    \param cancellation Token checked between phases and while waiting for the daemons
+ */
+void Session::sampleBatch(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                          const CancellationToken &cancellation)
+{
+    if(!m_FrontEnd) {
+        throw tr("Session::sampleBatch() frontEnd was null! This is not a valid value.");
+    }
+
+    cancellation.check();
+
+    STAT_FrontEnd *frontEnd = this->frontEnd();
+
+    float operationProgressScale = operationProgress.scale;
+
+    StatError_t statError;
+
+    beginPhase("Pause Application");
+    QElapsedTimer stoppedTime;
+    stoppedTime.invalidate();
+    if(frontEnd->isRunning()) {
+        stoppedTime.start();
+        if((statError = frontEnd->pause()) != STAT_OK) {
+            throw tr("Failed to pause application during sample: %1").arg(frontEnd->getLastErrorMessage());
+        }
+    }
+    emit paused(m_Id);
+
+    operationProgress.value += operationProgressScale * 7;
+    emit progress(operationProgress.value, m_Id);
+
+    beginPhase("Sample Stack Traces");
+    emit progressMessage(tr("Sample %1 Stack Traces").arg(options.traceCount), m_Id);
+    StatSample_t sampleType = STAT_FUNCTION_NAME_ONLY;
+    if(options.sampleType == IAdapter::Sample_FunctionAndPC) {
+        sampleType = STAT_FUNCTION_AND_PC;
+    } else if(options.sampleType == IAdapter::Sample_FunctionAndLine) {
+        sampleType = STAT_FUNCTION_AND_LINE;
+    }
+
+#ifdef COMPILEDADAPTER_DEBUG
+    Thread::sleep(100);
+    qDebug() << "STAT_FrontEnd::sampleStackTraces()" << options.traceCount << "traces";
+    Thread::sleep(100);
+#endif
+    //! \note The compiler warning for the string conversion is in the STAT_FrontEnd header; not our issue
+    statError = frontEnd->sampleStackTraces(sampleType, options.withThreads, options.clearOnSample,
+                                            options.traceCount, options.traceFrequency,
+                                            options.retryCount, options.retryFrequency,
+                                            false, const_cast<char *>("NULL"));
+    if(statError != STAT_OK) {
+        throw tr("Failed to sample stack traces: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    if((statError = waitAck(frontEnd, cancellation)) != STAT_OK) {
+        throw tr("Failed to sample stack traces: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    // Only resume if we were the ones that stopped it
+    if(options.nonStop && stoppedTime.isValid()) {
+        resumeAfterSample(stoppedTime, cancellation);
+    }
+
+    operationProgress.value += operationProgressScale * 93;
+    emit progress(operationProgress.value, m_Id);
+}
+
+void Session::sampleOne(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                        const CancellationToken &cancellation)
+{
+    if(!m_FrontEnd) {
+        throw tr("Session::sampleOne() frontEnd was null! This is not a valid value.");
+    }
+
+    cancellation.check();
+
+    STAT_FrontEnd *frontEnd = this->frontEnd();
+
+    float operationProgressScale = operationProgress.scale;
+
+    StatError_t statError;
+
+#ifdef COMPILEDADAPTER_DEBUG
+    Thread::sleep(100);
+    qDebug() << "STAT_FrontEnd::pause()";
+    Thread::sleep(100);
+#endif
+    beginPhase("Pause Application");
+    QElapsedTimer stoppedTime;
+    stoppedTime.invalidate();
+    if(frontEnd->isRunning()) {
+        stoppedTime.start();
+        if((statError = frontEnd->pause()) != STAT_OK) {
+            throw tr("Failed to pause application during sample: %1").arg(frontEnd->getLastErrorMessage());
+        }
+    }
+    emit paused(m_Id);
+
+    operationProgress.value += operationProgressScale * 7;
+    emit progress(operationProgress.value, m_Id);
+
+    beginPhase("Sample Stack Trace");
+    emit progressMessage("Sample Stack Trace", m_Id);
+    StatSample_t sampleType = STAT_FUNCTION_NAME_ONLY;
+    if(options.sampleType == IAdapter::Sample_FunctionAndPC) {
+        sampleType = STAT_FUNCTION_AND_PC;
+    } else if(options.sampleType == IAdapter::Sample_FunctionAndLine) {
+        sampleType = STAT_FUNCTION_AND_LINE;
+    }
+
+#ifdef COMPILEDADAPTER_DEBUG
+    Thread::sleep(100);
+    qDebug() << "STAT_FrontEnd::sampleStackTraces()";
+    Thread::sleep(100);
+#endif
+    //! \note The compiler warning for the string conversion is in the STAT_FrontEnd header; not our issue
+    statError = frontEnd->sampleStackTraces(sampleType, options.withThreads, options.clearOnSample,
+                                            options.traceCount, options.traceFrequency,
+                                            options.retryCount, options.retryFrequency,
+                                            false, const_cast<char *>("NULL"));
+    if(statError != STAT_OK) {
+        throw tr("Failed to sample stack trace: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+
+#ifdef COMPILEDADAPTER_DEBUG
+    Thread::sleep(100);
+    qDebug() << "STAT_FrontEnd::waitAck()";
+    Thread::sleep(100);
+#endif
+    if((statError = waitAck(frontEnd, cancellation)) != STAT_OK) {
+        throw tr("Failed to sample stack trace: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    // The traces are held by the daemons now; gathering them doesn't need the application stopped
+    if(options.nonStop && stoppedTime.isValid()) {
+        resumeAfterSample(stoppedTime, cancellation);
+    }
+    operationProgress.value += operationProgressScale * 36;
+    emit progress(operationProgress.value, m_Id);
+
+#ifdef COMPILEDADAPTER_DEBUG
+    Thread::sleep(100);
+    qDebug() << "STAT_FrontEnd::gatherLastTrace()";
+    Thread::sleep(100);
+#endif
+    beginPhase("Gather Stack Trace");
+    emit progressMessage("Gather Stack Trace", m_Id);
+    if((statError = frontEnd->gatherLastTrace(false)) != STAT_OK) {
+        throw tr("Failed to gather stack trace: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    if((statError = waitAck(frontEnd, cancellation)) != STAT_OK) {
+        throw tr("Failed to gather stack trace: %1").arg(frontEnd->getLastErrorMessage());
+    }
+    recordGather();
+    operationProgress.value += operationProgressScale * 14;
+    emit progress(operationProgress.value, m_Id);
+
+#ifdef COMPILEDADAPTER_DEBUG
+    Thread::sleep(100);
+    qDebug() << "STAT_FrontEnd::getLastDotFilename()";
+    Thread::sleep(100);
+#endif
+    beginPhase("Render Stack Trace");
+    emit progressMessage("Render Stack Trace", m_Id);
+    renderSample(frontEnd->getLastDotFilename(), options.ranks);
+
+    operationProgress.value += operationProgressScale * 43;
+    emit progress(operationProgress.value, m_Id);
+}
+
+/*! \fn Session::resumeAfterSample()
+    \brief Resumes an application that was stopped for a non-stop sample, and reports how long it was stopped
+    \param stoppedTime Started just before the application was paused
+    \param cancellation Token checked while waiting for the resume to be acknowledged
+
+    The stopped time runs until the resume has been acknowledged by the daemons, so it is an upper bound on the
+    time the application actually spent stopped.
+ */
+void Session::resumeAfterSample(const QElapsedTimer &stoppedTime, const CancellationToken &cancellation)
+{
+    resumeApplication(cancellation);
+
+    qint64 stopped = stoppedTime.elapsed();
+    m_LastStoppedTime = stopped;
+    emit phaseTimed("Application Stopped", stopped, m_Id);
+    emit progressMessage(tr("Application was stopped for %1 ms").arg(stopped), m_Id);
+}
+
+/*! \fn Session::renderSample()
+    \brief Hands the content of a rendered sample to the view
+    \param filename File that STAT rendered the merged graph to
+    \param ranks If not empty, only the call paths of these ranks are handed to the view
+
+    The file is read once here, on the worker thread, and the content is emitted with sampledContent() so the
+    view doesn't have to go back to the disk.  If output files aren't being kept, the file is removed in the
+    background and sampled() isn't emitted.  A kept file always holds every rank.
+ */
+void Session::renderSample(const QString &filename, const QList<quint64> &ranks)
+{
+    QFileInfo fileInfo(filename);
+    if(!fileInfo.exists()) {
+        throw tr("File does not exist: '%1'").arg(fileInfo.absoluteFilePath());
+    }
+
+    QFile file(fileInfo.absoluteFilePath());
+    if(!file.open(QIODevice::ReadOnly)) {
+        throw tr("Failed to open file: '%1'").arg(fileInfo.absoluteFilePath());
+    }
+    QByteArray content = file.readAll();
+    file.close();
+
+    if(!ranks.isEmpty()) {
+        content = DirectedGraph::DotRewriter::selectRanks(content, ranks);
+    }
+
+    emit sampledContent(content, fileInfo.absoluteFilePath(), m_Id);
+
+    if(keepOutputFiles()) {
+        emit sampled(fileInfo.absoluteFilePath(), m_Id);
+    } else {
+        QtConcurrent::run(removeFile, fileInfo.absoluteFilePath());
+    }
+}
+
+/*! \fn Session::launchMRNet()
+    \param options Topology options
+    \param cancellation Token checked between phases and while waiting for the tree to connect
+ */
+void Session::launchMRNet(const IAdapter::TopologyOptions &options, const CancellationToken &cancellation) {
+    if(!m_FrontEnd) {
+        throw tr("Session::launchMRNet() frontEnd was null! This is not a valid value.");
+    }
+
+    STAT_FrontEnd *frontEnd = this->frontEnd();
+
+    IAdapter::TopologyType requestedType = options.topologyType;
+    QString specification = options.topologySpecification;
+
+    // Replace STAT's automatic topology with one planned for the number of application nodes
+    m_TopologyPlan = TopologyPlanner::Plan();
+    if(requestedType == IAdapter::Topology_Auto && m_TopologyPlanner) {
+        beginPhase("Plan MRNet Tree");
+
+        quint64 leaves = frontEnd->getNumApplNodes();
+        quint64 processesPerNode = qMax(options.processesPerNode, (quint64)1);
+
+        // Without a node list, STAT places the communication processes on the front end's host
+        quint64 capacity = (options.nodeList.isEmpty() ? 1 : options.nodeList.count()) * processesPerNode;
+        if(options.shareApplicationNodes) {
+            capacity += leaves * processesPerNode;
+        }
+
+        m_TopologyPlan = m_TopologyPlanner->plan(leaves, capacity);
+        if(m_TopologyPlan.isValid()) {
+            requestedType = m_TopologyPlan.topologyType;
+            specification = m_TopologyPlan.specification;
+            emit progressMessage(tr("MRNet Tree Plan: %1").arg(m_TopologyPlan.toString()), m_Id);
+        }
+    }
+
+    FrontEnd::Topologies topologyType = FrontEnd::Topology_Auto;
+    if(requestedType == IAdapter::Topology_Depth) {
+        topologyType = FrontEnd::Topology_Depth;
+    } else if(requestedType == IAdapter::Topology_FanOut) {
+        topologyType = FrontEnd::Topology_FanOut;
+    } else if(requestedType == IAdapter::Topology_User) {
+        topologyType = FrontEnd::Topology_User;
+    }
+
+    // Both verbs are queued up front; the connect starts as soon as the launch returns.  The worker sleeps on the
+    // futures; cancel() cancels the queue, which stops the connect within one poll of STAT.
+    FrontEnd mrnet(frontEnd);
+    setPipeline(&mrnet);
+
+    try {
+#ifdef COMPILEDADAPTER_DEBUG
+        Thread::sleep(100);
+        qDebug() << "STAT_FrontEnd::launchMrnetTree()";
+        Thread::sleep(100);
+#endif
+        beginPhase("Launch MRNet Tree");
+        QFuture<FrontEnd::Error> launched = mrnet.launchMrnetTreeAsync(topologyType, specification,
+                                                                       options.nodeList.join(" "),
+                                                                       options.shareApplicationNodes);
+        QFuture<FrontEnd::Error> connected = mrnet.connectMrnetTreeAsync();
+
+        launched.waitForFinished();
+        cancellation.check();
+        if(launched.result() != FrontEnd::Error_OK) {
+            throw tr("Failed to launch MRNet tree: %1").arg(frontEnd->getLastErrorMessage());
+        }
+
+#ifdef COMPILEDADAPTER_DEBUG
+        Thread::sleep(100);
+        qDebug() << "STAT_FrontEnd::connectMrnetTree()";
+        Thread::sleep(100);
+#endif
+        beginPhase("Connect MRNet Tree");
+        connected.waitForFinished();
+        cancellation.check();
+        if(connected.result() != FrontEnd::Error_OK) {
+            throw tr("Failed to connect MRNet tree: %1").arg(frontEnd->getLastErrorMessage());
+        }
+    } catch(...) {
+        setPipeline(NULL);
+        throw;
+    }
+
+    setPipeline(NULL);
+}
+
+/*! \fn Session::setPipeline()
+    \brief Sets the FrontEnd queue that cancel() should stop, or NULL once the operation is done with it
+    \note If the operation was canceled before the queue was set, the queue is canceled at once
+ */
+void Session::setPipeline(FrontEnd *pipeline)
+{
+    QMutexLocker locker(&m_OperationMutex);
+
+    m_Pipeline = pipeline;
+    if(m_Pipeline && m_Cancellation.isCanceled()) {
+        m_Pipeline->cancel();
+    }
+}
+
+/*! \fn Session::recordGather()
+    \brief Records the time of the gather that just finished against the planned topology, if there is one
+    \note Called right after the gather has been acknowledged, while its phase is still being timed
+ */
+void Session::recordGather()
+{
+    if(m_TopologyPlanner && m_TopologyPlan.isValid() && m_Phase) {
+        m_TopologyPlanner->record(m_TopologyPlan, m_PhaseTimer.elapsed());
+    }
+}
+
+/*! \fn Session::attachApplication()
+ */
+void Session::attachApplication(const CancellationToken &cancellation)
+{
+    if(!m_FrontEnd) {
+        throw tr("Session::attachApplication() frontEnd was null! This is not a valid value.");
+    }
+
+    STAT_FrontEnd *frontEnd = this->frontEnd();
+
+    StatError_t statError;
+
+#ifdef COMPILEDADAPTER_DEBUG
+    Thread::sleep(100);
+    qDebug() << "STAT_FrontEnd::attachApplication()";
+    Thread::sleep(100);
+#endif
+    cancellation.check();
+
+    statError = frontEnd->attachApplication(false);
+    if(statError != STAT_OK) {
+        throw tr("Failed to attach application: %1").arg(frontEnd->getLastErrorMessage());
+    }
+
+    if((statError = waitAck(frontEnd, cancellation)) != STAT_OK) {
+        throw tr("Failed to attach application: %1").arg(frontEnd->getLastErrorMessage());
+    }
+}
+
+/*! \fn Session::reAttachApplication()
+    \brief Reattaches to the application through the daemons and MRNet tree left up by a previous detach
+    \returns false if the tools couldn't be reused, and have been shut down for a full reattach
+
+    Skips launching the daemons and connecting the tree, which dominate the attach time on large allocations.
+ */
+bool Session::reAttachApplication()
+{
+    beginOperation();
+
+    bool reattached = true;
+
+    try {
+
+        emit attaching(m_Id);
+        emit progress(10, m_Id);
+
+        beginPhase("Attach to Application");
+        emit progressMessage("Attach to Application", m_Id);
+        attachApplication(m_Cancellation);
+        emit progress(20, m_Id);
+
+        IAdapter::SampleOptions sampleOptions = *m_ReattachOptions;
+        sampleOptions.traceCount = 1;
+        sampleOptions.traceFrequency = 1;
+
+        OperationProgress operationProgress(30, 0.7);
+        sample(sampleOptions, operationProgress, m_Cancellation);
+        emit progress(100, m_Id);
+
+        m_Attached = true;
+        emit attached(m_Id);
+
+    } catch(CancellationToken::Canceled) {
+        operationCanceled();
+    } catch(QString err) {
+        emit progressMessage(tr("Unable to reuse running tools (%1); relaunching").arg(err), m_Id);
+        shutDown();
+        reattached = false;
+    } catch(...) {
+        emit progressMessage(tr("Unable to reuse running tools; relaunching"), m_Id);
+        shutDown();
+        reattached = false;
+    }
+
+    endOperation();
+
+    return reattached;
+}
+
+/*! \fn Session::waitAck()
+    \brief Helper function that waits for a FrontEnd to finish an operation.
+    \note This runs on the session's worker thread; the GUI thread is never blocked by it.
+
+    STAT_FrontEnd doesn't expose MRNet's event descriptor, so the acknowledgement thread blocks in receiveAck() and
+    wakes the worker when it returns.  The worker sleeps on the acknowledgement condition in between; it wakes only
+    for the acknowledgement itself or for cancel().
+ */
+StatError_t Session::waitAck(STAT_FrontEnd *frontEnd, const CancellationToken &cancellation)
+{
+    beginAckWait();
+
+    QMutexLocker locker(&m_AckMutex);
+    m_AckReceived = false;
+    m_AckPool.start(new AckReceiver(this, frontEnd));
+
+    while(!m_AckReceived) {
+        cancellation.check();
+        m_AckCondition.wait(&m_AckMutex);
+        ++m_AckWakeups;
+    }
+
+    StatError_t statError = m_AckResult;
+    locker.unlock();
+
+    endAckWait("receiveAck");
+
+    return statError;
+}
+
+/*! \fn Session::receiveAck()
+    \brief Blocks in STAT's receiveAck() until the daemons answer, then wakes the worker waiting in waitAck()
+    \note Runs on the session's acknowledgement thread
+ */
+void Session::receiveAck(STAT_FrontEnd *frontEnd)
+{
+    StatError_t statError = frontEnd->receiveAck(true);
+
+    QMutexLocker locker(&m_AckMutex);
+    m_AckResult = statError;
+    m_AckReceived = true;
+    m_AckCondition.wakeAll();
+}
+
+/*! \fn Session::beginAckWait()
+    \brief Resets the wakeup counter and clock before waiting on an acknowledgement
+ */
+void Session::beginAckWait()
+{
+    m_AckWakeups = 0;
+    m_AckTime.start();
+}
+
+/*! \fn Session::waitUntil()
+    \brief Blocks the worker thread until a deadline passes, without polling
+    \param clock Timer the deadline is measured against
+    \param deadline Milliseconds after the clock was started
+    \param cancellation Token checked on every wakeup; cancel() wakes the wait immediately
+
+    The wait shares the acknowledgement wait condition, so it uses no CPU until the deadline, cancellation or a
+    wakeAckWait() call.  The token is checked while holding the mutex, so a cancel() can't slip in unnoticed
+    between the check and the wait.
+ */
+void Session::waitUntil(const QElapsedTimer &clock, qint64 deadline, const CancellationToken &cancellation)
+{
+    QMutexLocker locker(&m_AckMutex);
+
+    qint64 remaining;
+    while((remaining = deadline - clock.elapsed()) > 0) {
+        cancellation.check();
+        m_AckCondition.wait(&m_AckMutex, (unsigned long)remaining);
+    }
+
+    cancellation.check();
+}
+
+/*! \fn Session::endAckWait()
+    \brief Adds the acknowledgement wait that just finished to the running operation's totals
+    \param operation Name of the STAT_FrontEnd call that was waited on
+ */
+void Session::endAckWait(const char *operation)
+{
+    m_OperationAckWakeups += m_AckWakeups;
+    m_OperationAckTime += m_AckTime.elapsed();
+
+#ifdef COMPILEDADAPTER_DEBUG
+    qDebug() << operation << "acknowledged after" << m_AckTime.elapsed() << "ms and" << m_AckWakeups << "wakeups";
+#else
+    Q_UNUSED(operation)
+#endif
+}
+
+/*! \fn Session::wakeAckWait()
+    \brief Wakes the worker thread if it is waiting on an acknowledgement, so it checks its cancellation token
+    \note Thread safe
+ */
+void Session::wakeAckWait()
+{
+    m_AckMutex.lock();
+    m_AckCondition.wakeAll();
+    m_AckMutex.unlock();
+}
+
+/*! \fn Session::keepOutputFiles()
+    \returns true if rendered files are left on disk after their content has been handed off
+ */
+bool Session::keepOutputFiles() const
+{
+    return (int)m_KeepOutputFiles != 0;
+}
+
+/*! \fn Session::setKeepOutputFiles()
+    \param keep false to remove rendered files once their content has been handed off
+    \note Thread safe; takes effect at the next rendered sample
+ */
+void Session::setKeepOutputFiles(bool keep)
+{
+    m_KeepOutputFiles = keep ? 1 : 0;
+}
+
+/*! \fn Session::setTopologyPlanner()
+    \param topologyPlanner Planner used for Topology_Auto trees; NULL leaves the choice to STAT
+ */
+void Session::setTopologyPlanner(TopologyPlanner *topologyPlanner)
+{
+    m_TopologyPlanner = topologyPlanner;
+}
+
+/*! \fn Session::toolsRunning()
+    \returns true while the daemons and MRNet tree are up, including after a detach that kept them running
+ */
+bool Session::toolsRunning() const
+{
+    return m_ToolsRunning;
+}
+
+/*! \fn Session::reattachOptions()
+    \returns Options the session was last launched or attached with, or NULL if it never was
+ */
+const IAdapter::Options *Session::reattachOptions() const
+{
+    return m_ReattachOptions;
+}
+
+/*! \fn Session::cancel()
+    \brief Requests that the operation currently running on this session be abandoned
+    \note Thread safe; this is called directly from the GUI thread while the worker is busy
+    \param dispatched True if the scheduler has handed an operation for this session to a worker; if it hasn't
+           begun yet, it is canceled as soon as it does
+    \returns true if an operation was in flight and will be canceled, false if the session was idle
+ */
+bool Session::cancel(bool dispatched)
+{
+    QMutexLocker locker(&m_OperationMutex);
+
+    if(!m_Busy) {
+        if(dispatched) {
+            m_PendingCancel = true;
+        }
+        return dispatched;
+    }
+
+    m_Cancellation.cancel();
+    if(m_Pipeline) {
+        m_Pipeline->cancel();
+    }
+    wakeAckWait();
+    return true;
+}
+
+/*! \fn Session::beginOperation()
+    \brief Marks the session as busy, so that cancel() requests are applied to the running operation
+ */
+void Session::beginOperation()
+{
+    qint64 queueWaitTime;
+
+    {
+        QMutexLocker locker(&m_OperationMutex);
+        m_Busy = true;
+
+        m_OperationAckWakeups = 0;
+        m_OperationAckTime = 0;
+
+        queueWaitTime = m_QueueWaitTime;
+        m_QueueWaitTime = -1;
+
+        if(m_PendingCancel) {
+            m_PendingCancel = false;
+            m_Cancellation.cancel();
+        }
+    }
+
+    if(queueWaitTime >= 0) {
+        emit phaseTimed("Scheduler Queue Wait", queueWaitTime, m_Id);
+    }
+}
+
+/*! \fn Session::discardPendingCancel()
+    \brief Called by the SessionScheduler once an operation has returned
+    \note A cancel() that arrived after the operation ended, but before the scheduler saw it return, had nothing
+          left to cancel; canceled() is emitted for it here, so the request is still answered
+ */
+void Session::discardPendingCancel()
+{
+    {
+        QMutexLocker locker(&m_OperationMutex);
+        if(!m_PendingCancel) {
+            return;
+        }
+        m_PendingCancel = false;
+    }
+
+    emit canceled(m_Id);
+    emit progressMessage(tr("Canceled"), m_Id);
+    emit progress(100, m_Id);
+}
+
+/*! \fn Session::setQueueWaitTime()
+    \brief Called by the SessionScheduler with the time the operation about to run spent queued
+ */
+void Session::setQueueWaitTime(qint64 milliseconds)
+{
+    QMutexLocker locker(&m_OperationMutex);
+    m_QueueWaitTime = milliseconds;
+}
+
+/*! \fn Session::ackWakeups()
+    \returns Number of times the worker woke up during the "Acknowledgement Wait" of the last operation that had one
+    \note Thread safe
+ */
+quint32 Session::ackWakeups() const
+{
+    return (quint32)(int)m_LastAckWakeups;
+}
+
+/*! \fn Session::endOperation()
+    \brief Marks the session as idle and clears any cancellation request aimed at the finished operation
+ */
+void Session::endOperation()
+{
+    endPhase();
+
+    // Total time spent waiting on STAT acknowledgements; the wakeup count is kept for ackWakeups()
+    if(m_OperationAckWakeups) {
+        m_LastAckWakeups = (int)m_OperationAckWakeups;
+        emit phaseTimed("Acknowledgement Wait", m_OperationAckTime, m_Id);
+    }
+
+    QMutexLocker locker(&m_OperationMutex);
+    m_Cancellation.reset();
+    m_Busy = false;
+}
+
+/*! \fn Session::operationCanceled()
+    \brief Tears down the FrontEnd, along with its MRNet tree and daemons, after an operation was canceled
+ */
+void Session::operationCanceled()
+{
+    emit progressMessage(tr("Shutting Down"), m_Id);
+
+    // STAT has no way to abort a request in flight; shutting the front end down releases the daemons and tree
+    shutDown();
+
+    emit canceled(m_Id);
+    emit progressMessage(tr("Canceled"), m_Id);
+    emit progress(100, m_Id);
+}
+
+/*! \fn Session::beginPhase()
+    \brief Finishes the current phase, if any, and starts timing a new one
+    \param phase Name reported through phaseTimed()
+ */
+void Session::beginPhase(const char *phase)
+{
+    endPhase();
+
+    m_Phase = phase;
+    m_PhaseTimer.start();
+}
+
+/*! \fn Session::endPhase()
+    \brief Reports the time spent in the current phase, if any, through phaseTimed()
+ */
+void Session::endPhase()
+{
+    if(!m_Phase) {
+        return;
+    }
+
+    qint64 milliseconds = m_PhaseTimer.elapsed();
+
+#ifdef COMPILEDADAPTER_DEBUG
+    qDebug() << m_Id.toString() << m_Phase << milliseconds << "ms";
+#endif
+
+    emit phaseTimed(QString(m_Phase), milliseconds, m_Id);
+    m_Phase = NULL;
+}
+
+/*! \fn Session::shutDown()
+    \brief Shuts down and destroys the STAT_FrontEnd owned by this session, if any
+ */
+void Session::shutDown()
+{
+    if(m_FrontEnd) {
+        try {
+            m_FrontEnd->shutDown();
+        } catch(...) { /* ignore */ }  //TODO: should probably log errors
+
+        // A canceled wait may have left receiveAck() blocked; the shut down tree releases it
+        m_AckPool.waitForDone();
+
+        delete m_FrontEnd;
+        m_FrontEnd = NULL;
+    }
+
+    m_Attached = false;
+    m_ToolsRunning = false;
+    m_TopologyPlan = TopologyPlanner::Plan();
+}
+
+/*! \fn Session::frontEnd()
+    \returns STAT_FrontEnd object owned by this session; created on first use
+ */
+STAT_FrontEnd *Session::frontEnd()
+{
+    if(!m_FrontEnd) {
+        m_FrontEnd = new STAT_FrontEnd;
+    }
+    return m_FrontEnd;
+}
+
+/*! \fn Session::errorToString()
+    \brief Converts STAT error enum value to QString for debug display
+    \param StatError_t
+    \returns string describing error
+ */
+QString Session::errorToString(StatError_t error)
+{
+    switch(error) {
+    case STAT_OK:
+        return tr("OK");
+        break;
+    case STAT_SYSTEM_ERROR:
+        return tr("System error");
+        break;
+    case STAT_MRNET_ERROR:
+        return tr("MRNet error");
+        break;
+    case STAT_FILTERLOAD_ERROR:
+        return tr("FilterLoad error");
+        break;
+    case STAT_GRAPHLIB_ERROR:
+        return tr("GraphLib error");
+        break;
+    case STAT_ALLOCATE_ERROR:
+        return tr("Allocate error");
+        break;
+    case STAT_ATTACH_ERROR:
+        return tr("Attach error");
+        break;
+    case STAT_DETACH_ERROR:
+        return tr("Detach error");
+        break;
+    case STAT_SEND_ERROR:
+        return tr("Send error");
+        break;
+    case STAT_SAMPLE_ERROR:
+        return tr("Sample error");
+        break;
+    case STAT_TERMINATE_ERROR:
+        return tr("Terminate error");
+        break;
+    case STAT_FILE_ERROR:
+        return tr("File error");
+        break;
+    case STAT_LMON_ERROR:
+        return tr("LaunchMON error");
+        break;
+    case STAT_ARG_ERROR:
+        return tr("ARG error");
+        break;
+    case STAT_VERSION_ERROR:
+        return tr("Version error");
+        break;
+    case STAT_NOT_LAUNCHED_ERROR:
+        return tr("NotLaunched error");
+        break;
+    case STAT_NOT_ATTACHED_ERROR:
+        return tr("NotAttached error");
+        break;
+    case STAT_NOT_CONNECTED_ERROR:
+        return tr("NotConnected error");
+        break;
+    case STAT_NO_SAMPLES_ERROR:
+        return tr("NoSamples error");
+        break;
+    case STAT_WARNING:
+        return tr("Warning error");
+        break;
+    case STAT_LOG_MESSAGE:
+        return tr("LogMessage Error");
+        break;
+    case STAT_STDOUT:
+        return tr("StdOut error");
+        break;
+    case STAT_VERBOSITY:
+        return tr("Verbosity error");
+        break;
+    case STAT_STACKWALKER_ERROR:
+        return tr("Stackwalker error");
+        break;
+    case STAT_PAUSE_ERROR:
+        return tr("Pause error");
+        break;
+    case STAT_RESUME_ERROR:
+        return tr("Resume error");
+        break;
+    case STAT_DAEMON_ERROR:
+        return tr("Daemon error");
+        break;
+    case STAT_APPLICATION_EXITED:
+        return tr("ApplicationExited error");
+        break;
+    case STAT_PENDING_ACK:
+        return tr("PendingAck error");
+        break;
+    default:
+        return tr("Unknown error");
+        break;
+    }
+}
+
+} // namespace CompiledAdapter
+} // namespace Plugins
@@ -0,0 +1,249 @@
+/*!
+   \file Session.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <QtCore>
+
+#include <STAT_FrontEnd.h>
+#include <SWAT/ConnectionManager/IAdapter.h>
+
+#include "TopologyPlanner.h"
+
+
+namespace Plugins {
+namespace CompiledAdapter {
+
+class FrontEnd;
+
+// Only way to get a calling thread to sleep using Qt4.
+class Thread : public QThread
+{
+public:
+    static void sleep(unsigned long msecs)
+    {
+        QThread::msleep(msecs);
+    }
+};
+
+/*! \brief Thread safe cancellation flag shared between the GUI thread and a session's worker thread
+ */
+class CancellationToken
+{
+public:
+    //! Thrown by check() to unwind an operation once it has been canceled
+    struct Canceled {};
+
+    CancellationToken() : m_Canceled(0) {}
+
+    void cancel() { m_Canceled = 1; }
+    void reset() { m_Canceled = 0; }
+    bool isCanceled() const { return (int)m_Canceled != 0; }
+    void check() const { if(isCanceled()) throw Canceled(); }
+
+private:
+    QAtomicInt m_Canceled;
+};
+
+class Session : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Session(const QUuid &id, QObject *parent = 0);
+    ~Session();
+
+    const QUuid &id() const;
+
+    bool cancel(bool dispatched = false);
+    void discardPendingCancel();
+
+    bool keepOutputFiles() const;
+    void setKeepOutputFiles(bool keep);
+
+    void setTopologyPlanner(TopologyPlanner *topologyPlanner);
+
+    bool toolsRunning() const;
+    const Plugins::SWAT::IAdapter::Options *reattachOptions() const;
+
+    void setQueueWaitTime(qint64 milliseconds);
+    quint32 ackWakeups() const;
+
+public slots:
+    void launch(const Plugins::SWAT::IAdapter::LaunchOptions &options);
+    void attach(const Plugins::SWAT::IAdapter::AttachOptions &options);
+    void reAttach();
+    void detach(const Plugins::SWAT::IAdapter::DetachOptions &options = Plugins::SWAT::IAdapter::DetachOptions());
+    void pause();
+    void resume();
+    void sample(const Plugins::SWAT::IAdapter::SampleOptions &options);
+    void sampleMultiple(const Plugins::SWAT::IAdapter::SampleOptions &options);
+    void shutDown();
+
+signals:
+    void progress(int progress, QUuid id);
+    void progressMessage(QString progress, QUuid id);
+    void launching(QUuid id);
+    void launched(QUuid id);
+    void attaching(QUuid id);
+    void attached(QUuid id);
+    void detaching(QUuid id);
+    void detached(QUuid id);
+    void pausing(QUuid id);
+    void paused(QUuid id);
+    void resuming(QUuid id);
+    void resumed(QUuid id);
+    void sampling(QUuid id);
+    void sampled(QString filename, QUuid id);
+    void sampledContent(QByteArray content, QString filename, QUuid id);
+    void canceling(QUuid id);
+    void canceled(QUuid id);
+    void failed(QString message, QUuid id);
+    void phaseTimed(QString phase, qint64 milliseconds, QUuid id);
+
+protected:
+    typedef Plugins::SWAT::IAdapter IAdapter;
+
+    struct OperationProgress {
+        OperationProgress(float value = 0, float scale = 1) { this->value = value; this->scale = scale; }
+        float value;
+        float scale;
+    };
+
+    STAT_FrontEnd *setupFrontEnd(const IAdapter::Options &options);
+    void launchMRNet(const IAdapter::TopologyOptions &options, const CancellationToken &cancellation);
+    void setPipeline(FrontEnd *pipeline);
+    void recordGather();
+
+    void attachApplication(const CancellationToken &cancellation);
+    void resumeApplication(const CancellationToken &cancellation);
+
+    void sample(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                const CancellationToken &cancellation);
+    void sampleMultiple(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                        const CancellationToken &cancellation);
+
+    void preSampleRunWait(const quint64 &runTimeWait, OperationProgress &operationProgress,
+                          const CancellationToken &cancellation);
+    void sampleOne(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                   const CancellationToken &cancellation);
+    void sampleBatch(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                     const CancellationToken &cancellation);
+    void sampleAdaptive(const IAdapter::SampleOptions &options, OperationProgress &operationProgress,
+                        const CancellationToken &cancellation);
+    void resumeAfterSample(const QElapsedTimer &stoppedTime, const CancellationToken &cancellation);
+    void renderSample(const QString &filename, const QList<quint64> &ranks = QList<quint64>());
+
+    StatError_t waitAck(STAT_FrontEnd *frontEnd, const CancellationToken &cancellation);
+    void receiveAck(STAT_FrontEnd *frontEnd);
+    void beginAckWait();
+    void endAckWait(const char *operation);
+    void wakeAckWait();
+    void waitUntil(const QElapsedTimer &clock, qint64 deadline, const CancellationToken &cancellation);
+
+    void beginOperation();
+    void endOperation();
+    void operationCanceled();
+
+    void beginPhase(const char *phase);
+    void endPhase();
+
+    STAT_FrontEnd *frontEnd();
+
+    static QString errorToString(StatError_t error);
+
+    bool reAttachApplication();
+
+    bool isAttached() const { return m_Attached; }
+    bool isRunning() const { return m_FrontEnd && m_FrontEnd->isRunning(); }
+
+private:
+    QUuid m_Id;
+    STAT_FrontEnd *m_FrontEnd;
+    bool m_Attached;
+
+    //! Daemons and MRNet tree are up; cleared only when the FrontEnd is shut down
+    bool m_ToolsRunning;
+
+    //! When false, rendered files are removed in the background once their content has been handed off
+    QAtomicInt m_KeepOutputFiles;
+
+    //! Plans Topology_Auto trees; shared with the other sessions, and not owned
+    TopologyPlanner *m_TopologyPlanner;
+    TopologyPlanner::Plan m_TopologyPlan;
+
+    //! Copy of the options used to launch or attach; kept for a later reattach
+    IAdapter::Options *m_ReattachOptions;
+
+    //! Pending acknowledgement wait state; the condition lets other threads cut a wait short
+    QMutex m_AckMutex;
+    QWaitCondition m_AckCondition;
+    QElapsedTimer m_AckTime;
+    quint32 m_AckWakeups;
+
+    //! Blocks in STAT_FrontEnd::receiveAck() for the worker; set under m_AckMutex when the acknowledgement arrives
+    QThreadPool m_AckPool;
+    bool m_AckReceived;
+    StatError_t m_AckResult;
+
+    //! Acknowledgement waits of the running operation, reported through phaseTimed() when it ends
+    quint32 m_OperationAckWakeups;
+    qint64 m_OperationAckTime;
+
+    //! Wakeups of the last operation that waited on an acknowledgement; read by ackWakeups()
+    QAtomicInt m_LastAckWakeups;
+
+    //! Set from the GUI thread by cancel(); checked by the worker between phases and inside ack waits
+    CancellationToken m_Cancellation;
+    QMutex m_OperationMutex;
+    bool m_Busy;
+
+    //! cancel() arrived after the scheduler handed an operation to a worker, but before it began
+    bool m_PendingCancel;
+
+    //! Time the next operation spent queued in the SessionScheduler; reported when it begins, -1 once it has been
+    qint64 m_QueueWaitTime;
+
+    //! FrontEnd queue the running operation is blocked on; cancel() cancels it.  Guarded by m_OperationMutex
+    FrontEnd *m_Pipeline;
+
+    //! Time the application was kept stopped by the last non-stop sample
+    qint64 m_LastStoppedTime;
+
+    //! Phase being timed for phaseTimed(); NULL between phases
+    const char *m_Phase;
+    QElapsedTimer m_PhaseTimer;
+
+    friend class AckReceiver;
+};
+
+} // namespace CompiledAdapter
+} // namespace Plugins
+
+#endif // SESSION_H
@@ -0,0 +1,348 @@
+/*!
+   \file SessionScheduler.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "SessionScheduler.h"
+
+#include "Session.h"
+
+#ifdef COMPILEDADAPTER_DEBUG
+#  include <QtDebug>
+#endif
+
+using namespace Plugins::SWAT;
+
+namespace Plugins {
+namespace CompiledAdapter {
+
+/*! \class SessionJob
+    \brief Runs a single scheduled operation on one of the scheduler's pooled threads
+ */
+class SessionJob : public QRunnable
+{
+public:
+    SessionJob(SessionScheduler *scheduler, Session *session, SessionScheduler::Operation *operation) :
+        m_Scheduler(scheduler), m_Session(session), m_Operation(operation)
+    {
+        setAutoDelete(true);
+    }
+
+    ~SessionJob()
+    {
+        delete m_Operation;
+    }
+
+    void run()
+    {
+        SessionScheduler::run(m_Session, m_Operation);
+        m_Scheduler->finished(m_Session);
+    }
+
+private:
+    SessionScheduler *m_Scheduler;
+    Session *m_Session;
+    SessionScheduler::Operation *m_Operation;
+};
+
+
+/*! \class SessionScheduler
+    \version 0.1.dev
+    \brief Runs session operations on a bounded pool of worker threads
+
+    Operations for different sessions run in parallel, up to maximumConcurrency() at once.  Operations for the
+    same session are run one at a time, in the order they were queued.  When a worker frees up, sessions with
+    pending work are served round-robin, so one session with a long queue can't starve the others.
+
+    Queue depth and the time operations spend waiting for a worker are kept in statistics().  Each operation's own
+    wait is also handed to its session, which reports it as the "Scheduler Queue Wait" phase.
+ */
+
+SessionScheduler::SessionScheduler(QObject *parent) :
+    QObject(parent),
+    m_MaximumConcurrency(qMax(QThread::idealThreadCount(), 1))
+{
+    m_ThreadPool.setMaxThreadCount(m_MaximumConcurrency);
+}
+
+SessionScheduler::~SessionScheduler()
+{
+    cancelAll();
+    waitForDone();
+}
+
+/*! \fn SessionScheduler::maximumConcurrency()
+    \returns Number of operations allowed to run at once
+ */
+int SessionScheduler::maximumConcurrency() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_MaximumConcurrency;
+}
+
+/*! \fn SessionScheduler::setMaximumConcurrency()
+    \brief Sets the number of operations allowed to run at once; operations already running are not affected
+    \param maximumConcurrency Limit; values below one are treated as one
+ */
+void SessionScheduler::setMaximumConcurrency(int maximumConcurrency)
+{
+    QMutexLocker locker(&m_Mutex);
+    m_MaximumConcurrency = qMax(maximumConcurrency, 1);
+    m_ThreadPool.setMaxThreadCount(m_MaximumConcurrency);
+    dispatch();
+}
+
+void SessionScheduler::enqueue(Session *session, OperationType type)
+{
+    enqueue(session, new Operation(type));
+}
+
+void SessionScheduler::enqueue(Session *session, const IAdapter::LaunchOptions &options)
+{
+    Operation *operation = new Operation(Operation_Launch);
+    operation->options = new IAdapter::LaunchOptions(options);
+    enqueue(session, operation);
+}
+
+void SessionScheduler::enqueue(Session *session, const IAdapter::AttachOptions &options)
+{
+    Operation *operation = new Operation(Operation_Attach);
+    operation->options = new IAdapter::AttachOptions(options);
+    enqueue(session, operation);
+}
+
+void SessionScheduler::enqueue(Session *session, const IAdapter::DetachOptions &options)
+{
+    Operation *operation = new Operation(Operation_Detach);
+    operation->detachOptions = options;
+    enqueue(session, operation);
+}
+
+void SessionScheduler::enqueue(Session *session, OperationType type, const IAdapter::SampleOptions &options)
+{
+    Operation *operation = new Operation(type);
+    operation->sampleOptions = options;
+    enqueue(session, operation);
+}
+
+void SessionScheduler::enqueue(Session *session, Operation *operation)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    operation->queuedTime.start();
+
+    QQueue<Operation *> &queue = m_Pending[session];
+    queue.enqueue(operation);
+    if(!m_Ring.contains(session)) {
+        m_Ring.append(session);
+    }
+
+    m_Statistics.queued++;
+    m_Statistics.queueDepth++;
+    m_Statistics.maximumQueueDepth = qMax(m_Statistics.maximumQueueDepth, m_Statistics.queueDepth);
+
+    dispatch();
+}
+
+/*! \fn SessionScheduler::cancel()
+    \brief Drops the operations that are still queued for a session
+    \param active If given, the operation handed to a worker for the session, if any, is canceled too, even if it
+           hasn't begun yet; set to true if there was one, in which case the session emits canceled() itself
+    \returns Number of operations dropped
+ */
+int SessionScheduler::cancel(Session *session, bool *active)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    if(active) {
+        *active = m_Active.contains(session) && session->cancel(true);
+    }
+
+    QQueue<Operation *> queue = m_Pending.take(session);
+    m_Ring.removeAll(session);
+
+    int count = queue.count();
+    m_Statistics.queueDepth -= count;
+    qDeleteAll(queue);
+
+    return count;
+}
+
+/*! \fn SessionScheduler::release()
+    \brief Drops a session's queued operations, and deletes the session once it has no operation running
+ */
+void SessionScheduler::release(Session *session)
+{
+    cancel(session);
+
+    QMutexLocker locker(&m_Mutex);
+
+    if(m_Active.contains(session)) {
+        m_Released.insert(session);
+    } else {
+        session->deleteLater();
+    }
+}
+
+/*! \fn SessionScheduler::cancelAll()
+    \brief Drops every queued operation, and asks every running operation to cancel
+ */
+void SessionScheduler::cancelAll()
+{
+    QMutexLocker locker(&m_Mutex);
+
+    foreach(QQueue<Operation *> queue, m_Pending) {
+        qDeleteAll(queue);
+    }
+    m_Pending.clear();
+    m_Ring.clear();
+    m_Statistics.queueDepth = 0;
+
+    foreach(Session *session, m_Active) {
+        session->cancel(true);
+    }
+}
+
+/*! \fn SessionScheduler::waitForDone()
+    \brief Blocks until every running operation has returned
+ */
+void SessionScheduler::waitForDone()
+{
+    m_ThreadPool.waitForDone();
+}
+
+/*! \fn SessionScheduler::statistics()
+    \returns Snapshot of the queue statistics
+    \note Thread safe
+ */
+SessionScheduler::Statistics SessionScheduler::statistics() const
+{
+    QMutexLocker locker(&m_Mutex);
+    Statistics statistics = m_Statistics;
+    statistics.running = m_Active.count();
+    return statistics;
+}
+
+/*! \fn SessionScheduler::dispatch()
+    \brief Starts queued operations until the concurrency limit is reached
+    \note Must be called with m_Mutex held
+ */
+void SessionScheduler::dispatch()
+{
+    int index = 0;
+    while(m_Active.count() < m_MaximumConcurrency && index < m_Ring.count()) {
+        Session *session = m_Ring.at(index);
+
+        // Sessions already running an operation wait their turn; this is what serializes each session
+        if(m_Active.contains(session)) {
+            ++index;
+            continue;
+        }
+
+        QQueue<Operation *> &queue = m_Pending[session];
+        Operation *operation = queue.dequeue();
+
+        // Move the session to the back of the ring; the next pick starts with the session after it
+        m_Ring.removeAt(index);
+        if(queue.isEmpty()) {
+            m_Pending.remove(session);
+        } else {
+            m_Ring.append(session);
+        }
+
+        operation->waitTime = operation->queuedTime.elapsed();
+        m_Statistics.started++;
+        m_Statistics.queueDepth--;
+        m_Statistics.totalWaitTime += operation->waitTime;
+        m_Statistics.maximumWaitTime = qMax(m_Statistics.maximumWaitTime, (quint64)operation->waitTime);
+
+#ifdef COMPILEDADAPTER_DEBUG
+        qDebug() << "SessionScheduler: starting operation" << operation->type << "for" << session->id().toString()
+                 << "after" << operation->waitTime << "ms queued;" << m_Statistics.queueDepth << "still queued";
+#endif
+
+        m_Active.insert(session);
+        m_ThreadPool.start(new SessionJob(this, session, operation));
+    }
+}
+
+/*! \fn SessionScheduler::finished()
+    \brief Called from a worker thread once an operation has returned
+ */
+void SessionScheduler::finished(Session *session)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    m_Active.remove(session);
+    m_Statistics.completed++;
+
+    session->discardPendingCancel();
+
+    // The session's thread deletes it; this worker is done with it
+    if(m_Released.remove(session)) {
+        session->deleteLater();
+    }
+
+    dispatch();
+}
+
+/*! \fn SessionScheduler::run()
+    \brief Runs an operation on the calling thread
+ */
+void SessionScheduler::run(Session *session, Operation *operation)
+{
+    session->setQueueWaitTime(operation->waitTime);
+
+    switch(operation->type) {
+    case Operation_Launch:
+        session->launch(*static_cast<IAdapter::LaunchOptions *>(operation->options));
+        break;
+    case Operation_Attach:
+        session->attach(*static_cast<IAdapter::AttachOptions *>(operation->options));
+        break;
+    case Operation_ReAttach:
+        session->reAttach();
+        break;
+    case Operation_Detach:
+        session->detach(operation->detachOptions);
+        break;
+    case Operation_Pause:
+        session->pause();
+        break;
+    case Operation_Resume:
+        session->resume();
+        break;
+    case Operation_Sample:
+        session->sample(operation->sampleOptions);
+        break;
+    case Operation_SampleMultiple:
+        session->sampleMultiple(operation->sampleOptions);
+        break;
+    }
+}
+
+} // namespace CompiledAdapter
+} // namespace Plugins
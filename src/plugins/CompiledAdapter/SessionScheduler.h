@@ -0,0 +1,133 @@
+/*!
+   \file SessionScheduler.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef SESSIONSCHEDULER_H
+#define SESSIONSCHEDULER_H
+
+#include <QtCore>
+
+#include <SWAT/ConnectionManager/IAdapter.h>
+
+
+namespace Plugins {
+namespace CompiledAdapter {
+
+class Session;
+class SessionJob;
+
+class SessionScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum OperationType {
+        Operation_Launch = 0,
+        Operation_Attach,
+        Operation_ReAttach,
+        Operation_Detach,
+        Operation_Pause,
+        Operation_Resume,
+        Operation_Sample,
+        Operation_SampleMultiple
+    };
+
+    struct Statistics {
+        Statistics() : queued(0), started(0), completed(0), queueDepth(0), maximumQueueDepth(0),
+                       running(0), totalWaitTime(0), maximumWaitTime(0) {}
+
+        quint64 queued;             //!< Operations accepted since the scheduler was created
+        quint64 started;            //!< Operations handed to a worker thread
+        quint64 completed;          //!< Operations that have returned
+        int queueDepth;             //!< Operations currently waiting for a worker
+        int maximumQueueDepth;      //!< Largest queue depth seen
+        int running;                //!< Operations currently running
+        quint64 totalWaitTime;      //!< Sum of the time started operations spent queued (ms)
+        quint64 maximumWaitTime;    //!< Longest time an operation spent queued (ms)
+
+        quint64 averageWaitTime() const { return started ? totalWaitTime / started : 0; }
+
+    explicit SessionScheduler(QObject *parent = 0);
+    ~SessionScheduler();
+
+    int maximumConcurrency() const;
+    void setMaximumConcurrency(int maximumConcurrency);
+
+    void enqueue(Session *session, OperationType type);
+    void enqueue(Session *session, const Plugins::SWAT::IAdapter::LaunchOptions &options);
+    void enqueue(Session *session, const Plugins::SWAT::IAdapter::AttachOptions &options);
+    void enqueue(Session *session, const Plugins::SWAT::IAdapter::DetachOptions &options);
+    void enqueue(Session *session, OperationType type, const Plugins::SWAT::IAdapter::SampleOptions &options);
+    int cancel(Session *session, bool *active = NULL);
+    void release(Session *session);
+    void cancelAll();
+    void waitForDone();
+
+    Statistics statistics() const;
+
+protected:
+    struct Operation {
+        Operation(OperationType type) : type(type), options(NULL), waitTime(0) {}
+        ~Operation() { if(options) delete options; }
+
+        OperationType type;
+        Plugins::SWAT::IAdapter::Options *options;              //!< Launch or attach options; owned
+        Plugins::SWAT::IAdapter::SampleOptions sampleOptions;
+        Plugins::SWAT::IAdapter::DetachOptions detachOptions;
+        QElapsedTimer queuedTime;
+        qint64 waitTime;                                        //!< Time spent queued; set when it's started
+    };
+
+    void enqueue(Session *session, Operation *operation);
+    void dispatch();
+    void finished(Session *session);
+    static void run(Session *session, Operation *operation);
+
+private:
+    mutable QMutex m_Mutex;
+    QThreadPool m_ThreadPool;
+    int m_MaximumConcurrency;
+
+    //! Pending operations per session; each session runs at most one operation at a time
+    QHash<Session *, QQueue<Operation *> > m_Pending;
+    QSet<Session *> m_Active;
+
+    //! Released sessions still running an operation; they're deleted once it returns
+    QSet<Session *> m_Released;
+
+    //! Round-robin order of sessions with pending operations
+    QList<Session *> m_Ring;
+
+    Statistics m_Statistics;
+
+    friend class SessionJob;
+};
+
+} // namespace CompiledAdapter
+} // namespace Plugins
+
+#endif // SESSIONSCHEDULER_H
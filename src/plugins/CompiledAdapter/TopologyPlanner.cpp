@@ -0,0 +1,315 @@
+/*!
+   \file TopologyPlanner.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "TopologyPlanner.h"
+
+#include <SettingManager/SettingManager.h>
+
+using namespace Plugins::SWAT;
+
+namespace Plugins {
+namespace CompiledAdapter {
+
+static const double defaultHopLatency = 20.0;
+static const double defaultChildCost = 1.0;
+static const int maximumSamples = 100;
+
+/*! \class TopologyPlanner
+    \version 0.1.dev
+    \brief Plans a balanced MRNet tree for the number of application nodes, minimizing the expected gather time
+
+    The expected gather time of a tree is modeled as a fixed latency per level, plus a merge cost for each child
+    of the busiest parent in that level.  Every tree depth that fits in the available communication processes is
+    costed, and the cheapest one is planned as a STAT user topology.
+
+    The gather times achieved with a plan are recorded, and the two model parameters are refit from them with a
+    least squares fit, so later plans follow the machine that they run on.  The recorded times are kept in the
+    "topology/gatherHistory" setting.
+ */
+
+TopologyPlanner::TopologyPlanner() :
+    m_HopLatency(defaultHopLatency),
+    m_ChildCost(defaultChildCost)
+{
+}
+
+/*! \fn TopologyPlanner::plan()
+    \brief Plans the tree for a job
+    \param leaves Number of daemons; one for each application node
+    \param capacity Largest number of communication processes that can be placed
+    \param maximumDepth Deepest tree to consider
+    \returns The plan with the lowest expected gather time; an invalid plan if there are no leaves
+ */
+TopologyPlanner::Plan TopologyPlanner::plan(quint64 leaves, quint64 capacity, int maximumDepth) const
+{
+    QMutexLocker locker(&m_Mutex);
+
+    Plan best;
+    if(leaves == 0) {
+        return best;
+    }
+
+    for(int depth = 1; depth <= qMax(maximumDepth, 1); ++depth) {
+
+        // Smallest fan-out that reaches every leaf in this many hops
+        quint64 fanOut = (quint64)qFloor(qPow((qreal)leaves, 1.0 / depth));
+        fanOut = qMax(fanOut, (quint64)1);
+        forever {
+            quint64 reach = 1;
+            for(int i = 0; i < depth && reach < leaves; ++i) {
+                reach *= fanOut;
+            }
+            if(reach >= leaves) {
+                break;
+            }
+            ++fanOut;
+        }
+
+        // A deeper tree can't do better once the fan-out bottoms out
+        if(depth > 1 && fanOut < 2) {
+            break;
+        }
+
+        // Size each level from the bottom up, so the processes are spread evenly over the leaves
+        QList<quint64> levelCounts;
+        quint64 width = leaves;
+        quint64 communicationProcesses = 0;
+        for(int level = depth - 1; level > 0; --level) {
+            width = (width + fanOut - 1) / fanOut;
+            levelCounts.prepend(width);
+            communicationProcesses += width;
+        }
+
+        if(communicationProcesses > capacity) {
+            continue;
+        }
+
+        quint64 parents = 1;
+        quint64 load = 0;
+        for(int level = 0; level < depth; ++level) {
+            quint64 children = (level < levelCounts.count()) ? levelCounts.at(level) : leaves;
+            load += (children + parents - 1) / parents;
+            parents = children;
+        }
+
+        double expectedGatherTime = m_HopLatency * depth + m_ChildCost * load;
+        if(best.isValid() && expectedGatherTime >= best.expectedGatherTime) {
+            continue;
+        }
+
+        best.leaves = leaves;
+        best.depth = depth;
+        best.levelCounts = levelCounts;
+        best.load = load;
+        best.expectedGatherTime = expectedGatherTime;
+
+        if(levelCounts.isEmpty()) {
+            best.topologyType = IAdapter::Topology_Depth;
+            best.specification = QString("0");
+        } else {
+            QStringList counts;
+            foreach(quint64 count, levelCounts) {
+                counts.append(QString::number(count));
+            }
+            best.topologyType = IAdapter::Topology_User;
+            best.specification = counts.join("-");
+        }
+    }
+
+    return best;
+}
+
+/*! \fn TopologyPlanner::Plan::toString()
+    \returns Short description of the plan, suitable for a progress message
+ */
+QString TopologyPlanner::Plan::toString() const
+{
+    if(levelCounts.isEmpty()) {
+        return TopologyPlanner::tr("flat tree to %1 daemons, expected gather %2 ms")
+                .arg(leaves).arg(expectedGatherTime, 0, 'f', 0);
+    }
+
+    return TopologyPlanner::tr("%1 levels of communication processes (%2) over %3 daemons, expected gather %4 ms")
+            .arg(levelCounts.count()).arg(specification).arg(leaves).arg(expectedGatherTime, 0, 'f', 0);
+}
+
+/*! \fn TopologyPlanner::record()
+    \brief Records the gather time achieved with a plan, and refits the model
+    \note Thread safe
+ */
+void TopologyPlanner::record(const Plan &plan, qint64 milliseconds)
+{
+    if(!plan.isValid() || milliseconds < 0) {
+        return;
+    }
+
+    QMutexLocker locker(&m_Mutex);
+
+    Sample sample;
+    sample.depth = plan.depth;
+    sample.load = plan.load;
+    sample.milliseconds = milliseconds;
+    m_Samples.append(sample);
+
+    while(m_Samples.count() > maximumSamples) {
+        m_Samples.removeFirst();
+    }
+
+    fit();
+}
+
+/*! \fn TopologyPlanner::fit()
+    \brief Refits the model parameters to the recorded samples
+    \note The caller must hold the mutex
+
+    With samples from at least two different tree shapes, both parameters come from the least squares solution.
+    Otherwise the samples only say how far off the model is overall, so both parameters are scaled by that.
+ */
+void TopologyPlanner::fit()
+{
+    if(m_Samples.isEmpty()) {
+        m_HopLatency = defaultHopLatency;
+        m_ChildCost = defaultChildCost;
+        return;
+    }
+
+    double sumDepthDepth = 0, sumDepthLoad = 0, sumLoadLoad = 0;
+    double sumDepthTime = 0, sumLoadTime = 0;
+    double sumTime = 0, sumPredicted = 0;
+    foreach(Sample sample, m_Samples) {
+        double depth = sample.depth;
+        double load = sample.load;
+        double time = sample.milliseconds;
+
+        sumDepthDepth += depth * depth;
+        sumDepthLoad += depth * load;
+        sumLoadLoad += load * load;
+        sumDepthTime += depth * time;
+        sumLoadTime += load * time;
+        sumTime += time;
+        sumPredicted += m_HopLatency * depth + m_ChildCost * load;
+    }
+
+    static const double minimum = 0.001;
+
+    double determinant = sumDepthDepth * sumLoadLoad - sumDepthLoad * sumDepthLoad;
+    if(qAbs(determinant) > 1e-9 * sumDepthDepth * sumLoadLoad) {
+        double hopLatency = (sumDepthTime * sumLoadLoad - sumLoadTime * sumDepthLoad) / determinant;
+        double childCost = (sumLoadTime * sumDepthDepth - sumDepthTime * sumDepthLoad) / determinant;
+        if(hopLatency > 0 && childCost > 0) {
+            m_HopLatency = hopLatency;
+            m_ChildCost = childCost;
+            return;
+        }
+    }
+
+    if(sumPredicted > 0) {
+        double scale = sumTime / sumPredicted;
+        m_HopLatency = qMax(m_HopLatency * scale, minimum);
+        m_ChildCost = qMax(m_ChildCost * scale, minimum);
+    }
+}
+
+/*! \fn TopologyPlanner::hopLatency()
+    \returns Modeled latency of each level of the tree, in milliseconds
+ */
+double TopologyPlanner::hopLatency() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_HopLatency;
+}
+
+/*! \fn TopologyPlanner::childCost()
+    \returns Modeled cost of merging each child at a parent, in milliseconds
+ */
+double TopologyPlanner::childCost() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_ChildCost;
+}
+
+QList<TopologyPlanner::Sample> TopologyPlanner::samples() const
+{
+    QMutexLocker locker(&m_Mutex);
+    return m_Samples;
+}
+
+/*! \fn TopologyPlanner::readSettings()
+    \brief Loads the recorded gather times and fits the model to them
+ */
+void TopologyPlanner::readSettings()
+{
+    Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+    settingManager.beginGroup("Plugins/CompiledAdapter");
+    QStringList history = settingManager.value("topology/gatherHistory", QStringList()).toStringList();
+    settingManager.endGroup();
+
+    QMutexLocker locker(&m_Mutex);
+
+    m_Samples.clear();
+    foreach(QString entry, history) {
+        QStringList fields = entry.split(",");
+        if(fields.count() != 3) {
+            continue;
+        }
+
+        Sample sample;
+        sample.depth = fields.at(0).toInt();
+        sample.load = fields.at(1).toULongLong();
+        sample.milliseconds = fields.at(2).toLongLong();
+        if(sample.depth > 0 && sample.load > 0) {
+            m_Samples.append(sample);
+        }
+    }
+
+    m_HopLatency = defaultHopLatency;
+    m_ChildCost = defaultChildCost;
+    fit();
+}
+
+/*! \fn TopologyPlanner::writeSettings()
+    \brief Stores the recorded gather times as "depth,load,milliseconds" entries
+ */
+void TopologyPlanner::writeSettings() const
+{
+    QStringList history;
+    {
+        QMutexLocker locker(&m_Mutex);
+        foreach(Sample sample, m_Samples) {
+            history.append(QString("%1,%2,%3").arg(sample.depth).arg(sample.load).arg(sample.milliseconds));
+        }
+    }
+
+    Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+    settingManager.beginGroup("Plugins/CompiledAdapter");
+    settingManager.setValue("topology/gatherHistory", history);
+    settingManager.endGroup();
+}
+
+} // namespace CompiledAdapter
+} // namespace Plugins
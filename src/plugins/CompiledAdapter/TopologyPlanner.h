@@ -0,0 +1,98 @@
+/*!
+   \file TopologyPlanner.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef TOPOLOGYPLANNER_H
+#define TOPOLOGYPLANNER_H
+
+#include <QtCore>
+
+#include <SWAT/ConnectionManager/IAdapter.h>
+
+
+namespace Plugins {
+namespace CompiledAdapter {
+
+class TopologyPlanner
+{
+    Q_DECLARE_TR_FUNCTIONS(TopologyPlanner)
+
+public:
+    struct Plan {
+        Plan() : leaves(0), depth(1), load(0), expectedGatherTime(0),
+                 topologyType(Plugins::SWAT::IAdapter::Topology_Auto) {}
+
+        quint64 leaves;                 //!< Daemons at the bottom of the tree
+        int depth;                      //!< Hops from the front end to the daemons; 1 is a flat tree
+        QList<quint64> levelCounts;     //!< Communication processes in each level, top down
+        quint64 load;                   //!< Sum of the largest fan-in at each level
+        double expectedGatherTime;      //!< Milliseconds, predicted by the model when the plan was made
+
+        Plugins::SWAT::IAdapter::TopologyType topologyType;
+        QString specification;          //!< Passed to STAT along with topologyType
+
+        bool isValid() const { return leaves > 0; }
+        QString toString() const;
+    };
+
+    struct Sample {
+        int depth;
+        quint64 load;
+        qint64 milliseconds;
+    };
+
+    TopologyPlanner();
+
+    Plan plan(quint64 leaves, quint64 capacity, int maximumDepth = 4) const;
+    void record(const Plan &plan, qint64 milliseconds);
+
+    double hopLatency() const;
+    double childCost() const;
+    QList<Sample> samples() const;
+
+    void readSettings();
+    void writeSettings() const;
+
+protected:
+    void fit();
+
+private:
+    mutable QMutex m_Mutex;
+
+    //! Gather latency model: hopLatency per level plus childCost per child merged at the busiest parent
+    double m_HopLatency;
+    double m_ChildCost;
+
+    //! Achieved gather times; the model is refit from these whenever one is added
+    QList<Sample> m_Samples;
+
+};
+
+} // namespace CompiledAdapter
+} // namespace Plugins
+
+#endif // TOPOLOGYPLANNER_H
@@ -0,0 +1,489 @@
+/*!
+   \file ReplayAdapter.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "ReplayAdapter.h"
+
+#include "ReplaySession.h"
+
+#include <SettingManager/SettingManager.h>
+
+using namespace Plugins::SWAT;
+
+namespace Plugins {
+namespace ReplayAdapter {
+
+/*! \class ReplayAdapter
+    \version 0.1.dev
+    \brief SWAT adapter that replays recorded .dot/.grl samples instead of talking to STAT
+
+    Every operation is played back as the same phases, progress values and signals that the CompiledAdapter
+    emits; each phase takes latency() milliseconds, give or take up to jitter() milliseconds.  Samples are served
+    from the files in replayPath(), in name order, wrapping around at the end.  This lets the GUI side be load
+    tested without a cluster.
+
+    Configured through the "Plugins/ReplayAdapter" settings group ("replay/path", "replay/latency" and
+    "replay/jitter"); the SWAT_REPLAY_PATH environment variable overrides the path.  A single phase can be
+    given its own latency and jitter with "replay/latency/<phase>" and "replay/jitter/<phase>", where the phase
+    is the step's progress message (e.g. "replay/latency/Gather Stack Trace").  The adapter is only registered
+    when a path has been configured.
+ */
+
+ReplayAdapter::ReplayAdapter(QObject *parent) :
+    IAdapter(parent),
+    m_Latency(250),
+    m_Jitter(0)
+{
+    setObjectName("ReplayAdapter");
+}
+
+ReplayAdapter::~ReplayAdapter()
+{
+    qDeleteAll(m_Sessions);
+    m_Sessions.clear();
+}
+
+/*! \fn ReplayAdapter::readSettings()
+    \brief Reads the replay path, latency and jitter from the SettingManager
+ */
+void ReplayAdapter::readSettings()
+{
+    Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+    settingManager.beginGroup("Plugins/ReplayAdapter");
+
+    QString replayPath = settingManager.value("replay/path", QString()).toString();
+    setLatency(settingManager.value("replay/latency", m_Latency).toInt());
+    setJitter(settingManager.value("replay/jitter", m_Jitter).toInt());
+
+    settingManager.endGroup();
+
+    // Per-phase overrides are looked up as the phases are played back
+    m_PhaseLatency.clear();
+    m_PhaseJitter.clear();
+
+    QByteArray environmentPath = qgetenv("SWAT_REPLAY_PATH");
+    if(!environmentPath.isEmpty()) {
+        replayPath = QString::fromLocal8Bit(environmentPath);
+    }
+
+    setReplayPath(replayPath);
+}
+
+/*! \fn ReplayAdapter::isEnabled()
+    \returns true if a replay path has been configured
+ */
+bool ReplayAdapter::isEnabled() const
+{
+    return !m_ReplayPath.isEmpty();
+}
+
+const QString &ReplayAdapter::replayPath() const
+{
+    return m_ReplayPath;
+}
+
+/*! \fn ReplayAdapter::setReplayPath()
+    \brief Sets the directory to replay, and caches the list of .dot/.grl files found in it
+ */
+void ReplayAdapter::setReplayPath(const QString &replayPath)
+{
+    m_ReplayPath = replayPath;
+    m_ReplayFiles.clear();
+    m_ReplayContent.clear();
+
+    if(m_ReplayPath.isEmpty()) {
+        return;
+    }
+
+    QStringList nameFilters;
+    nameFilters << "*.dot" << "*.grl";
+
+    QDir directory(m_ReplayPath);
+    foreach(QFileInfo fileInfo, directory.entryInfoList(nameFilters, QDir::Files | QDir::Readable, QDir::Name)) {
+        m_ReplayFiles.append(fileInfo.absoluteFilePath());
+    }
+}
+
+/*! \fn ReplayAdapter::latency()
+    \returns Nominal duration of each replayed phase, in milliseconds
+ */
+int ReplayAdapter::latency() const
+{
+    return m_Latency;
+}
+
+void ReplayAdapter::setLatency(int latency)
+{
+    m_Latency = qMax(latency, 0);
+}
+
+/*! \fn ReplayAdapter::jitter()
+    \returns Largest random deviation from latency() for each replayed phase, in milliseconds
+ */
+int ReplayAdapter::jitter() const
+{
+    return m_Jitter;
+}
+
+void ReplayAdapter::setJitter(int jitter)
+{
+    m_Jitter = qMax(jitter, 0);
+}
+
+const QStringList &ReplayAdapter::replayFiles() const
+{
+    return m_ReplayFiles;
+}
+
+/*! \fn ReplayAdapter::replayContent()
+    \brief Content of a replayed .dot file; read from disk the first time and served from memory afterwards
+    \param filename One of replayFiles()
+    \returns The file's content, or an empty array for formats that have to be loaded from the file itself
+ */
+QByteArray ReplayAdapter::replayContent(const QString &filename)
+{
+    if(m_ReplayContent.contains(filename)) {
+        return m_ReplayContent.value(filename);
+    }
+
+    QByteArray content;
+    if(QFileInfo(filename).suffix().compare("dot") == 0) {
+        QFile file(filename);
+        if(file.open(QIODevice::ReadOnly)) {
+            content = file.readAll();
+            file.close();
+        }
+    }
+
+    m_ReplayContent.insert(filename, content);
+    return content;
+}
+
+/*! \fn ReplayAdapter::stepDelay()
+    \param phase Phase about to be played back; its "replay/latency/<phase>" and "replay/jitter/<phase>"
+           settings override latency() and jitter() when they are set
+    \returns Duration of the next replayed phase; the latency plus a uniformly distributed jitter
+ */
+int ReplayAdapter::stepDelay(const QString &phase) const
+{
+    int latency = m_Latency;
+    int jitter = m_Jitter;
+    if(!phase.isEmpty()) {
+        latency = phaseSetting(m_PhaseLatency, "replay/latency/", phase, m_Latency);
+        jitter = phaseSetting(m_PhaseJitter, "replay/jitter/", phase, m_Jitter);
+    }
+
+    int delay = latency;
+    if(jitter > 0) {
+        delay += (qrand() % (2 * jitter + 1)) - jitter;
+    }
+    return qMax(delay, 0);
+}
+
+/*! \fn ReplayAdapter::phaseSetting()
+    \brief Looks up a per-phase override, caching the answer until the settings are read again
+    \param cache Overrides already looked up, by phase
+    \param key Setting prefix the phase is appended to
+    \param phase
+    \param value Global setting, used when the phase has no override
+    \returns The phase's override if one is set, otherwise value
+ */
+int ReplayAdapter::phaseSetting(QHash<QString, int> &cache, const QString &key, const QString &phase, int value) const
+{
+    if(!cache.contains(phase)) {
+        Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+        settingManager.beginGroup("Plugins/ReplayAdapter");
+        QVariant setting = settingManager.value(key + phase, QVariant());
+        settingManager.endGroup();
+
+        bool ok = false;
+        int phaseValue = setting.toInt(&ok);
+        cache.insert(phase, (setting.isValid() && ok) ? qMax(phaseValue, 0) : -1);
+    }
+
+    int phaseValue = cache.value(phase);
+    return (phaseValue < 0) ? value : phaseValue;
+}
+
+ReplaySession *ReplayAdapter::createSession(const QUuid &id)
+{
+    ReplaySession *session = new ReplaySession(id, this);
+
+    connect(session, SIGNAL(progress(int,QUuid)), this, SIGNAL(progress(int,QUuid)));
+    connect(session, SIGNAL(progressMessage(QString,QUuid)), this, SIGNAL(progressMessage(QString,QUuid)));
+    connect(session, SIGNAL(launched(QUuid)), this, SIGNAL(launched(QUuid)));
+    connect(session, SIGNAL(attached(QUuid)), this, SIGNAL(attached(QUuid)));
+    connect(session, SIGNAL(detached(QUuid)), this, SIGNAL(detached(QUuid)));
+    connect(session, SIGNAL(paused(QUuid)), this, SIGNAL(paused(QUuid)));
+    connect(session, SIGNAL(resumed(QUuid)), this, SIGNAL(resumed(QUuid)));
+    connect(session, SIGNAL(sampled(QString,QUuid)), this, SIGNAL(sampled(QString,QUuid)));
+    connect(session, SIGNAL(sampledContent(QByteArray,QString,QUuid)), this, SIGNAL(sampledContent(QByteArray,QString,QUuid)));
+    connect(session, SIGNAL(failed(QString,QUuid)), this, SIGNAL(failed(QString,QUuid)));
+    connect(session, SIGNAL(phaseTimed(QString,qint64,QUuid)), this, SIGNAL(phaseTimed(QString,qint64,QUuid)));
+
+    m_Sessions.insert(id, session);
+
+    return session;
+}
+
+ReplaySession *ReplayAdapter::session(const QUuid &id)
+{
+    if(!m_Sessions.contains(id)) {
+        throw tr("FrontEnd with the specified ID was not found.");
+    }
+
+    return m_Sessions.value(id);
+}
+
+/*! \fn ReplayAdapter::addAttachSteps()
+    \brief Queues the phases shared by launch and attach, up to and including the first sample
+ */
+void ReplayAdapter::addAttachSteps(ReplaySession *session)
+{
+    session->addStep(tr("Starting Front End"), 5);
+    session->addStep(tr("Launch Daemons"), 10);
+    session->addStep(tr("Connect to Daemons"), 15);
+    session->addStep(tr("Attach to Application"), 20);
+    session->addStep(tr("Sample Stack Trace"), 50);
+    session->addStep(tr("Gather Stack Trace"), 70);
+    session->addStep(tr("Render Stack Trace"), 90, ReplaySession::Action_Sampled);
+}
+
+QUuid ReplayAdapter::launch(const LaunchOptions &options)
+{
+    Q_UNUSED(options)
+
+    QUuid id = QUuid::createUuid();
+    ReplaySession *session = createSession(id);
+
+    emit launching(id);
+    emit progress(1, id);
+
+    addAttachSteps(session);
+    session->addStep(QString(), 100, ReplaySession::Action_Launched, 0);
+
+    return id;
+}
+
+QUuid ReplayAdapter::attach(const AttachOptions &options)
+{
+    Q_UNUSED(options)
+
+    QUuid id = QUuid::createUuid();
+    ReplaySession *session = createSession(id);
+
+    emit attaching(id);
+
+    addAttachSteps(session);
+    session->addStep(QString(), 100, ReplaySession::Action_Attached, 0);
+
+    return id;
+}
+
+void ReplayAdapter::reAttach(const QUuid &id)
+{
+    ReplaySession *session = this->session(id);
+
+    if(session->isAttached()) {
+        throw tr("Unable to reattach; already attached!");
+    }
+
+    emit attaching(id);
+
+    if(session->toolsRunning()) {
+        // Daemons and tree were kept running by the detach
+        session->addStep(tr("Attach to Application"), 20);
+        session->addStep(tr("Sample Stack Trace"), 50);
+        session->addStep(tr("Gather Stack Trace"), 70);
+        session->addStep(tr("Render Stack Trace"), 90, ReplaySession::Action_Sampled);
+    } else {
+        addAttachSteps(session);
+    }
+    session->addStep(QString(), 100, ReplaySession::Action_Attached, 0);
+}
+
+void ReplayAdapter::detach(const QUuid &id, const DetachOptions &options)
+{
+    ReplaySession *session = this->session(id);
+
+    if(!session->isAttached() && !session->toolsRunning()) {
+        throw tr("Unable to detach; not already attached.");
+    }
+
+    emit detaching(id);
+
+    session->setToolsRunning(options.keepToolsRunning);
+    if(!options.stopList.isEmpty()) {
+        session->addStep(tr("Left %n rank(s) stopped", 0, options.stopList.count()), -1);
+    }
+    session->addStep(QString(), -1, ReplaySession::Action_Detached);
+}
+
+void ReplayAdapter::pause(const QUuid &id)
+{
+    ReplaySession *session = this->session(id);
+
+    emit pausing(id);
+
+    session->addStep(QString(), -1, ReplaySession::Action_Paused);
+}
+
+void ReplayAdapter::resume(const QUuid &id)
+{
+    ReplaySession *session = this->session(id);
+
+    emit resuming(id);
+
+    session->addStep(QString(), -1, ReplaySession::Action_Resumed);
+}
+
+void ReplayAdapter::sample(const SampleOptions &options, const QUuid &id)
+{
+    ReplaySession *session = this->session(id);
+
+    if(options.runTimeBeforeSample > 0) {
+        session->addStep(QString(), -1, ReplaySession::Action_Resumed, 0);
+        session->addStep(tr("Waiting for Pre-Sample Run Time"), 5, ReplaySession::Action_None,
+                         (int)(options.runTimeBeforeSample * 1000));
+    }
+
+    session->addStep(QString(), 10, ReplaySession::Action_Paused);
+    session->addStep(tr("Sample Stack Trace"), 40);
+    if(options.nonStop) {
+        session->addStep(tr("Resume Application"), -1, ReplaySession::Action_Resumed);
+    }
+    session->addStep(tr("Gather Stack Trace"), 60);
+    session->addStep(tr("Render Stack Trace"), 100, ReplaySession::Action_Sampled, -1, options.ranks);
+}
+
+void ReplayAdapter::sampleMultiple(const SampleOptions &options, const QUuid &id)
+{
+    ReplaySession *session = this->session(id);
+
+    if(options.runTimeBeforeSample > 0) {
+        session->addStep(QString(), -1, ReplaySession::Action_Resumed, 0);
+        session->addStep(tr("Waiting for Pre-Sample Run Time"), 5, ReplaySession::Action_None,
+                         (int)(options.runTimeBeforeSample * 1000));
+    }
+
+    session->addStep(QString(), 10, ReplaySession::Action_Paused);
+
+    if(options.perturbationBudget > 0) {
+        // Replayed samples stop the application for one step delay; space them as the budget allows, smoothing
+        // the stopped time the way the CompiledAdapter does
+        const double budget = qMin(options.perturbationBudget, 1.0);
+        double expectedStoppedTime = -1;
+        for(quint64 i = 0; i < options.traceCount; ++i) {
+            int value = 10 + (int)((80 * (i + 1)) / options.traceCount);
+            int stoppedTime = stepDelay(tr("Sample Stack Trace"));
+            if(i > 0) {
+                session->addStep(QString(), -1, ReplaySession::Action_Paused);
+            }
+            session->addStep(tr("Sample Stack Trace"), -1, ReplaySession::Action_None, stoppedTime);
+            session->addStep(tr("Resume Application"), value, ReplaySession::Action_Resumed);
+            if(options.gatherIndividualSamples) {
+                session->addStep(tr("Gather Stack Trace"), -1);
+                session->addStep(tr("Render Stack Trace"), -1, ReplaySession::Action_Sampled, -1, options.ranks);
+            }
+            if(i + 1 >= options.traceCount) {
+                break;
+            }
+
+            if(expectedStoppedTime < 0) {
+                expectedStoppedTime = stoppedTime;
+            } else {
+                expectedStoppedTime = (expectedStoppedTime + stoppedTime) / 2;
+            }
+            int interval = qMax((int)qCeil(expectedStoppedTime / budget), (int)options.traceFrequency);
+
+            session->addTimedStep("Adaptive Sample Interval",
+                                  tr("Sample %1 of %2 stopped the application for %3 ms; next sample in %4 ms")
+                                  .arg(i + 1).arg(options.traceCount).arg(stoppedTime).arg(interval),
+                                  interval);
+        }
+    } else if(options.gatherIndividualSamples) {
+        // One round trip and rendered sample per trace, as the CompiledAdapter does
+        for(quint64 i = 0; i < options.traceCount; ++i) {
+            int value = 10 + (int)((80 * (i + 1)) / options.traceCount);
+            if(options.nonStop && i > 0) {
+                session->addStep(QString(), -1, ReplaySession::Action_Paused);
+            }
+            session->addStep(tr("Sample Stack Trace"), -1);
+            if(options.nonStop) {
+                session->addStep(tr("Resume Application"), -1, ReplaySession::Action_Resumed);
+            }
+            session->addStep(tr("Gather Stack Trace"), -1);
+            session->addStep(tr("Render Stack Trace"), value, ReplaySession::Action_Sampled, -1, options.ranks);
+        }
+    } else {
+        QString phase = tr("Sample %1 Stack Traces").arg(options.traceCount);
+        session->addStep(phase, 50, ReplaySession::Action_None,
+                         stepDelay(phase) + (int)(options.traceCount * options.traceFrequency));
+        if(options.nonStop) {
+            session->addStep(tr("Resume Application"), -1, ReplaySession::Action_Resumed);
+        }
+    }
+
+    session->addStep(tr("Gather Stack Traces"), 95);
+    session->addStep(tr("Render Stack Traces"), 100, ReplaySession::Action_Sampled, -1, options.ranks);
+}
+
+const QString &ReplayAdapter::defaultFilterPath() const
+{
+    return m_ReplayPath;
+}
+
+const QString &ReplayAdapter::defaultToolDaemonPath() const
+{
+    return m_ReplayPath;
+}
+
+const QString &ReplayAdapter::installPath() const
+{
+    return m_ReplayPath;
+}
+
+const QString &ReplayAdapter::outputPath() const
+{
+    return m_ReplayPath;
+}
+
+void ReplayAdapter::cancel(const QUuid &id)
+{
+    emit canceling(id);
+    emit progressMessage(tr("Canceling"), id);
+    emit progress(99, id);
+
+    session(id)->cancel();
+
+    emit canceled(id);
+    emit progressMessage(tr("Canceled"), id);
+    emit progress(100, id);
+}
+
+} // namespace ReplayAdapter
+} // namespace Plugins
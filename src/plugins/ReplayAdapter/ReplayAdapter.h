@@ -0,0 +1,105 @@
+/*!
+   \file ReplayAdapter.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef REPLAYADAPTER_H
+#define REPLAYADAPTER_H
+
+#include <QtCore>
+
+#include <SWAT/ConnectionManager/IAdapter.h>
+
+
+namespace Plugins {
+namespace ReplayAdapter {
+
+class ReplaySession;
+
+class ReplayAdapter : public Plugins::SWAT::IAdapter
+{
+    Q_OBJECT
+    Q_INTERFACES(Plugins::SWAT::IAdapter)
+
+public:
+    explicit ReplayAdapter(QObject *parent = 0);
+    ~ReplayAdapter();
+
+    QUuid launch(const LaunchOptions &options);
+    QUuid attach(const AttachOptions &options);
+    void reAttach(const QUuid &id);
+    void detach(const QUuid &id, const DetachOptions &options = DetachOptions());
+    void pause(const QUuid &id);
+    void resume(const QUuid &id);
+    void sample(const SampleOptions &options, const QUuid &id);
+    void sampleMultiple(const SampleOptions &options, const QUuid &id);
+
+    const QString &defaultFilterPath() const;
+    const QString &defaultToolDaemonPath() const;
+    const QString &installPath() const;
+    const QString &outputPath() const;
+
+    void readSettings();
+    bool isEnabled() const;
+
+    const QString &replayPath() const;
+    void setReplayPath(const QString &replayPath);
+    int latency() const;
+    void setLatency(int latency);
+    int jitter() const;
+    void setJitter(int jitter);
+
+    const QStringList &replayFiles() const;
+    QByteArray replayContent(const QString &filename);
+    int stepDelay(const QString &phase = QString()) const;
+
+public slots:
+    void cancel(const QUuid &id);
+
+protected:
+    ReplaySession *createSession(const QUuid &id);
+    ReplaySession *session(const QUuid &id);
+
+    void addAttachSteps(ReplaySession *session);
+    int phaseSetting(QHash<QString, int> &cache, const QString &key, const QString &phase, int value) const;
+
+private:
+    QHash<QUuid, ReplaySession*> m_Sessions;
+
+    QString m_ReplayPath;
+    QStringList m_ReplayFiles;
+    QHash<QString, QByteArray> m_ReplayContent;
+    int m_Latency;
+    int m_Jitter;
+    mutable QHash<QString, int> m_PhaseLatency;
+    mutable QHash<QString, int> m_PhaseJitter;
+
+};
+
+} // namespace ReplayAdapter
+} // namespace Plugins
+
+#endif // REPLAYADAPTER_H
@@ -0,0 +1,139 @@
+/*!
+   \file ReplayAdapterPlugin.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "ReplayAdapterPlugin.h"
+
+#include <PluginManager/PluginManager.h>
+
+using namespace Plugins::SWAT;
+
+namespace Plugins {
+namespace ReplayAdapter {
+
+/*! \namespace Plugins::ReplayAdapter
+    \brief Contains the ReplayAdapterPlugin.
+ */
+
+/*! \class ReplayAdapterPlugin
+    \version 0.1.dev
+    \brief Registers the ReplayAdapter, when a replay directory has been configured
+
+    \par Depends on Plugins:
+         SWAT
+
+    \todo Document this more explicitly.
+ */
+
+/*!
+   \fn ReplayAdapterPlugin::ReplayAdapterPlugin()
+   \brief Constructor.
+ */
+ReplayAdapterPlugin::ReplayAdapterPlugin(QObject *parent) :
+    QObject(parent)
+{
+    m_Name = "ReplayAdapter";
+    m_Version = QString("%1.%2.%3").arg(VER_MAJ).arg(VER_MIN).arg(VER_PAT);
+    m_Dependencies.append( Core::PluginManager::Dependency("SWAT", QString("^%1\\.%2.*$").arg(VER_MAJ).arg(VER_MIN)) );
+}
+
+/*!
+   \fn ReplayAdapterPlugin::~ReplayAdapterPlugin()
+   \brief Destructor.
+ */
+ReplayAdapterPlugin::~ReplayAdapterPlugin()
+{
+}
+
+/*!
+   \fn ReplayAdapterPlugin::initialize()
+   \brief
+   \returns true if successful
+ */
+bool ReplayAdapterPlugin::initialize(QStringList &args, QString *err)
+{
+    Q_UNUSED(args)
+    Q_UNUSED(err)
+
+    try {
+        // The most recently registered adapter becomes the current one; only take over when asked to replay
+        m_ReplayAdapter.readSettings();
+        if(!m_ReplayAdapter.isEnabled()) {
+            return true;
+        }
+
+        Core::PluginManager::PluginManager &pluginManager = Core::PluginManager::PluginManager::instance();
+        pluginManager.addObject(&m_ReplayAdapter);
+    } catch(...) {
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+   \fn ReplayAdapterPlugin::shutdown()
+   \brief
+ */
+void ReplayAdapterPlugin::shutdown()
+{
+}
+
+/*!
+   \fn ReplayAdapterPlugin::name()
+   \brief
+   \returns name of plugin
+ */
+QString ReplayAdapterPlugin::name()
+{
+    return m_Name;
+}
+
+/*!
+   \fn ReplayAdapterPlugin::version()
+   \brief
+   \returns version of plugin
+ */
+QString ReplayAdapterPlugin::version()
+{
+    return m_Version;
+}
+
+/*!
+   \fn ReplayAdapterPlugin::dependencies()
+   \brief
+   \returns list of dependecies
+ */
+QList<Core::PluginManager::Dependency> ReplayAdapterPlugin::dependencies()
+{
+    return m_Dependencies;
+}
+
+} // namespace ReplayAdapter
+} // namespace Plugins
+
+Q_EXPORT_PLUGIN(Plugins::ReplayAdapter::ReplayAdapterPlugin)
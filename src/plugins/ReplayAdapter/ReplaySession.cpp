@@ -0,0 +1,193 @@
+/*!
+   \file ReplaySession.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "ReplaySession.h"
+
+#include "ReplayAdapter.h"
+
+#include <SWAT/DirectedGraph/DotRewriter.h>
+
+namespace Plugins {
+namespace ReplayAdapter {
+
+/*! \class ReplaySession
+    \version 0.1.dev
+    \brief Plays back the phases of the operations queued on one replayed FrontEnd
+
+    Steps are run one at a time from a single-shot timer on the GUI thread, so operations on the same session
+    are serialized and the caller never blocks, just like the CompiledAdapter.
+ */
+
+ReplaySession::ReplaySession(const QUuid &id, ReplayAdapter *adapter) :
+    QObject(adapter),
+    m_Id(id),
+    m_Adapter(adapter),
+    m_Attached(false),
+    m_ToolsRunning(false),
+    m_NextFile(0)
+{
+    m_Timer.setSingleShot(true);
+    connect(&m_Timer, SIGNAL(timeout()), this, SLOT(nextStep()));
+}
+
+const QUuid &ReplaySession::id() const
+{
+    return m_Id;
+}
+
+/*! \fn ReplaySession::addStep()
+    \brief Queues a phase to be played back
+    \param message Progress message emitted when the step runs; nothing is emitted if empty
+    \param progress Progress value emitted when the step runs; nothing is emitted if negative
+    \param action Completion signal emitted when the step runs
+    \param delay Milliseconds to wait before the step runs; -1 uses the adapter's latency and jitter for the phase
+    \param ranks Ranks the content of a sampled step is cut down to; all of them if empty
+ */
+void ReplaySession::addStep(const QString &message, int progress, ActionType action, int delay,
+                            const QList<quint64> &ranks)
+{
+    Step step;
+    step.phase = message;
+    step.message = message;
+    step.progress = progress;
+    step.action = action;
+    step.delay = delay;
+    step.ranks = ranks;
+    m_Steps.enqueue(step);
+
+    if(!m_Timer.isActive()) {
+        scheduleNextStep();
+    }
+}
+
+/*! \fn ReplaySession::addTimedStep()
+    \brief Queues a wait that is timed under a fixed phase name, announced by its own progress message
+    \param phase Phase the wait is timed as
+    \param message Progress message emitted as the wait begins; nothing is emitted if empty
+    \param delay Milliseconds to wait
+ */
+void ReplaySession::addTimedStep(const QString &phase, const QString &message, int delay)
+{
+    Step step;
+    step.message = message;
+    step.progress = -1;
+    step.action = Action_None;
+    step.delay = 0;
+    m_Steps.enqueue(step);
+
+    step.phase = phase;
+    step.message = QString();
+    step.delay = delay;
+    m_Steps.enqueue(step);
+
+    if(!m_Timer.isActive()) {
+        scheduleNextStep();
+    }
+}
+
+/*! \fn ReplaySession::cancel()
+    \brief Drops every step that hasn't been played back yet
+ */
+void ReplaySession::cancel()
+{
+    m_Timer.stop();
+    m_Steps.clear();
+}
+
+void ReplaySession::scheduleNextStep()
+{
+    if(m_Steps.isEmpty()) {
+        return;
+    }
+
+    const Step &step = m_Steps.head();
+    m_Timer.start((step.delay < 0) ? m_Adapter->stepDelay(step.phase) : step.delay);
+    m_StepTime.start();
+}
+
+void ReplaySession::nextStep()
+{
+    if(m_Steps.isEmpty()) {
+        return;
+    }
+
+    Step step = m_Steps.dequeue();
+
+    if(!step.phase.isEmpty()) {
+        emit phaseTimed(step.phase, m_StepTime.elapsed(), m_Id);
+    }
+    if(!step.message.isEmpty()) {
+        emit progressMessage(step.message, m_Id);
+    }
+
+    if(step.progress >= 0) {
+        emit progress(step.progress, m_Id);
+    }
+
+    switch(step.action) {
+    case Action_Launched:
+        m_Attached = true;
+        emit launched(m_Id);
+        break;
+    case Action_Attached:
+        m_Attached = true;
+        emit attached(m_Id);
+        break;
+    case Action_Detached:
+        m_Attached = false;
+        emit detached(m_Id);
+        break;
+    case Action_Paused:
+        emit paused(m_Id);
+        break;
+    case Action_Resumed:
+        emit resumed(m_Id);
+        break;
+    case Action_Sampled:
+    {
+        const QStringList &files = m_Adapter->replayFiles();
+        if(files.isEmpty()) {
+            cancel();
+            emit failed(tr("No .dot or .grl files to replay in '%1'").arg(m_Adapter->replayPath()), m_Id);
+            return;
+        }
+
+        QString filename = files.at(m_NextFile++ % files.count());
+        emit sampledContent(DirectedGraph::DotRewriter::selectRanks(m_Adapter->replayContent(filename), step.ranks), filename, m_Id);
+        emit sampled(filename, m_Id);
+        break;
+    }
+    case Action_None:
+        break;
+    }
+
+    scheduleNextStep();
+}
+
+} // namespace ReplayAdapter
+} // namespace Plugins
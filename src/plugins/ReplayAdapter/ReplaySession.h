@@ -0,0 +1,113 @@
+/*!
+   \file ReplaySession.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef REPLAYSESSION_H
+#define REPLAYSESSION_H
+
+#include <QtCore>
+
+#include <SWAT/ConnectionManager/IAdapter.h>
+
+
+namespace Plugins {
+namespace ReplayAdapter {
+
+class ReplayAdapter;
+
+class ReplaySession : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ActionType {
+        Action_None = 0,
+        Action_Launched,
+        Action_Attached,
+        Action_Detached,
+        Action_Paused,
+        Action_Resumed,
+        Action_Sampled
+    };
+
+    explicit ReplaySession(const QUuid &id, ReplayAdapter *adapter);
+
+    const QUuid &id() const;
+    bool isAttached() const { return m_Attached; }
+    bool toolsRunning() const { return m_ToolsRunning; }
+    void setToolsRunning(bool toolsRunning) { m_ToolsRunning = toolsRunning; }
+    bool isBusy() const { return !m_Steps.isEmpty(); }
+
+    void addStep(const QString &message, int progress, ActionType action = Action_None, int delay = -1,
+                 const QList<quint64> &ranks = QList<quint64>());
+    void addTimedStep(const QString &phase, const QString &message, int delay);
+    void cancel();
+
+signals:
+    void progress(int progress, QUuid id);
+    void progressMessage(QString progress, QUuid id);
+    void launched(QUuid id);
+    void attached(QUuid id);
+    void detached(QUuid id);
+    void paused(QUuid id);
+    void resumed(QUuid id);
+    void sampled(QString filename, QUuid id);
+    void sampledContent(QByteArray content, QString filename, QUuid id);
+    void failed(QString message, QUuid id);
+    void phaseTimed(QString phase, qint64 milliseconds, QUuid id);
+
+protected slots:
+    void nextStep();
+
+protected:
+    struct Step {
+        QString phase;      //!< Phase the step's delay is timed as; nothing is timed if empty
+        QString message;
+        int progress;
+        ActionType action;
+        int delay;          //!< Milliseconds before this step runs; -1 uses the phase's latency and jitter
+        QList<quint64> ranks;   //!< Ranks a sampled step is cut down to; all of them if empty
+    };
+
+    void scheduleNextStep();
+
+private:
+    QUuid m_Id;
+    ReplayAdapter *m_Adapter;
+    QQueue<Step> m_Steps;
+    QTimer m_Timer;
+    QElapsedTimer m_StepTime;
+    bool m_Attached;
+    bool m_ToolsRunning;
+    int m_NextFile;
+
+};
+
+} // namespace ReplayAdapter
+} // namespace Plugins
+
+#endif // REPLAYSESSION_H
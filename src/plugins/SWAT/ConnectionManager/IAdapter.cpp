@@ -34,6 +34,12 @@ namespace SWAT {
 IAdapter::IAdapter(QObject *parent) :
     QObject(parent)
 {
+    // Adapters may emit from worker threads; the queued connections need to know these types
+    qRegisterMetaType<QUuid>("QUuid");
+    qRegisterMetaType<qint64>("qint64");
+    qRegisterMetaType<IAdapter::LaunchOptions>("Plugins::SWAT::IAdapter::LaunchOptions");
+    qRegisterMetaType<IAdapter::AttachOptions>("Plugins::SWAT::IAdapter::AttachOptions");
+    qRegisterMetaType<IAdapter::SampleOptions>("Plugins::SWAT::IAdapter::SampleOptions");
 }
 
 } // namespace SWAT
@@ -104,6 +104,10 @@ public:
         quint64 retryFrequency;
         quint64 traceCount;
         quint64 traceFrequency;
+        bool gatherIndividualSamples;   //!< Sample and gather each trace separately, instead of as one batch
+        bool nonStop;                   //!< Resume the application as soon as the traces have been taken
+        double perturbationBudget;      //!< If above zero, space the samples so the application is stopped for at most this fraction of the time
+        QList<quint64> ranks;           //!< If not empty, only the call paths of these ranks are handed to the view
 
         quint64 runTimeBeforeSample;
     };
@@ -157,6 +161,16 @@ public:
         QStringList args;
     };
 
+    /*! \brief Options for detach operations
+        \sa IAdapter::detach()
+     */
+    struct DetachOptions {
+        DetachOptions() : keepToolsRunning(false) {}
+
+        bool keepToolsRunning;  //!< Leave the daemons and MRNet tree up, so a reattach only reattaches the application
+        QList<quint64> stopList; //!< Ranks left stopped after the detach, so that a debugger can be attached to them
+    };
+
     /*******************************/
 
     explicit IAdapter(QObject *parent = 0);
@@ -181,10 +195,13 @@ public:
     virtual void reAttach(const QUuid &id) = 0;
 
     /*! \fn CompiledAdapter::detach()
-        \brief
-        \returns
+        \brief Detach from the application
+        \param id Unique ID of the associated FrontEnd
+        \param options With keepToolsRunning set, the tools are left up for a fast reAttach(); detaching again
+                       without it shuts them down.  Ranks in stopList are left stopped, rather than resumed
+                       along with the rest of the job
      */
-    virtual void detach(const QUuid &id) = 0;
+    virtual void detach(const QUuid &id, const DetachOptions &options = DetachOptions()) = 0;
 
     /*! \fn CompiledAdapter::pause()
         \brief
@@ -211,7 +228,6 @@ public:
     virtual void sampleMultiple(const SampleOptions &options, const QUuid &id) = 0;
 
 
-
     virtual const QString &defaultFilterPath() const = 0;
     virtual const QString &defaultToolDaemonPath() const = 0;
     virtual const QString &installPath() const = 0;
@@ -308,6 +324,14 @@ signals:
      */
     void sampled(QString filename, QUuid id);
 
+    /*! \fn CompiledAdapter::sampledContent()
+        \brief Emitted when a sample operation has finished, with the rendered content already in memory
+        \param content Rendered graph content; empty if the format can only be loaded from filename
+        \param filename Path the content was rendered to; it may be removed once the content is handed off
+        \param id Unique ID of the associated FrontEnd
+     */
+    void sampledContent(QByteArray content, QString filename, QUuid id);
+
     /*! \fn CompiledAdapter::canceling()
         \brief Emitted when a cancel operation is initiated
         \param id Unique ID of the associated FrontEnd
@@ -319,6 +343,21 @@ signals:
         \param id Unique ID of the associated FrontEnd
      */
     void canceled(QUuid id);
+
+    /*! \fn CompiledAdapter::failed()
+        \brief Emitted when an operation could not be completed
+        \param message String describing the failure
+        \param id Unique ID of the associated FrontEnd
+     */
+    void failed(QString message, QUuid id);
+
+    /*! \fn CompiledAdapter::phaseTimed()
+        \brief Emitted when a phase of an operation finishes
+        \param phase Name of the phase (e.g. "Launch Daemons", "Connect MRNet Tree", "Gather Stack Trace")
+        \param milliseconds Time spent in the phase, as measured by a monotonic clock
+        \param id Unique ID of the associated FrontEnd
+     */
+    void phaseTimed(QString phase, qint64 milliseconds, QUuid id);
 };
 
 } // namespace SWAT
@@ -0,0 +1,198 @@
+/*!
+   \file PhaseHistory.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "PhaseHistory.h"
+
+namespace Plugins {
+namespace SWAT {
+
+/*! \class PhaseHistory
+    \version 0.1.dev
+    \brief Rolling history of the phase timings reported by an adapter's phaseTimed() signal
+
+    The most recent maximumEntries() timings are kept for each FrontEnd, and can be exported as CSV or JSON.
+ */
+
+PhaseHistory::PhaseHistory(int maximumEntries, QObject *parent) :
+    QObject(parent),
+    m_MaximumEntries(qMax(maximumEntries, 1))
+{
+}
+
+/*! \fn PhaseHistory::maximumEntries()
+    \returns Number of timings kept for each FrontEnd
+ */
+int PhaseHistory::maximumEntries() const
+{
+    return m_MaximumEntries;
+}
+
+void PhaseHistory::setMaximumEntries(int maximumEntries)
+{
+    m_MaximumEntries = qMax(maximumEntries, 1);
+
+    QMutableHashIterator<QUuid, QList<Entry> > iterator(m_Entries);
+    while(iterator.hasNext()) {
+        QList<Entry> &entries = iterator.next().value();
+        while(entries.count() > m_MaximumEntries) {
+            entries.removeFirst();
+        }
+    }
+}
+
+/*! \fn PhaseHistory::ids()
+    \returns IDs of the FrontEnds that have recorded timings
+ */
+QList<QUuid> PhaseHistory::ids() const
+{
+    return m_Entries.keys();
+}
+
+/*! \fn PhaseHistory::entries()
+    \returns Recorded timings for a FrontEnd, oldest first
+ */
+QList<PhaseHistory::Entry> PhaseHistory::entries(const QUuid &id) const
+{
+    return m_Entries.value(id);
+}
+
+void PhaseHistory::clear()
+{
+    m_Entries.clear();
+}
+
+/*! \fn PhaseHistory::record()
+    \brief Appends a timing; meant to be connected to IAdapter::phaseTimed()
+ */
+void PhaseHistory::record(QString phase, qint64 milliseconds, QUuid id)
+{
+    Entry entry;
+    entry.finished = QDateTime::currentDateTime();
+    entry.phase = phase;
+    entry.milliseconds = milliseconds;
+
+    QList<Entry> &entries = m_Entries[id];
+    entries.append(entry);
+    if(entries.count() > m_MaximumEntries) {
+        entries.removeFirst();
+    }
+}
+
+/*! \fn PhaseHistory::toCsv()
+    \returns Every recorded timing, one row per phase
+ */
+QString PhaseHistory::toCsv() const
+{
+    QString csv;
+    QTextStream stream(&csv);
+
+    stream << "id,finished,phase,milliseconds\n";
+    QHashIterator<QUuid, QList<Entry> > iterator(m_Entries);
+    while(iterator.hasNext()) {
+        iterator.next();
+        foreach(Entry entry, iterator.value()) {
+            QString phase = entry.phase;
+            phase.replace('"', "\"\"");
+            stream << iterator.key().toString() << ","
+                   << entry.finished.toString(Qt::ISODate) << ","
+                   << "\"" << phase << "\","
+                   << entry.milliseconds << "\n";
+        }
+    }
+
+    return csv;
+}
+
+/*! \fn PhaseHistory::toJson()
+    \returns Every recorded timing, as an object of arrays keyed by FrontEnd ID
+ */
+QString PhaseHistory::toJson() const
+{
+    QStringList sessions;
+
+    QHashIterator<QUuid, QList<Entry> > iterator(m_Entries);
+    while(iterator.hasNext()) {
+        iterator.next();
+
+        QStringList entries;
+        foreach(Entry entry, iterator.value()) {
+            entries.append(QString("    { \"finished\": \"%1\", \"phase\": \"%2\", \"milliseconds\": %3 }")
+                           .arg(entry.finished.toString(Qt::ISODate))
+                           .arg(escapeJson(entry.phase))
+                           .arg(entry.milliseconds));
+        }
+
+        sessions.append(QString("  \"%1\": [\n%2\n  ]").arg(iterator.key().toString()).arg(entries.join(",\n")));
+    }
+
+    return QString("{\n%1\n}\n").arg(sessions.join(",\n"));
+}
+
+/*! \fn PhaseHistory::exportToFile()
+    \brief Writes every recorded timing to a file; JSON if the file name ends in ".json", CSV otherwise
+ */
+void PhaseHistory::exportToFile(const QString &filename) const
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        throw tr("Could not open file for writing: '%1'").arg(filename);
+    }
+
+    QTextStream stream(&file);
+    if(filename.endsWith(".json", Qt::CaseInsensitive)) {
+        stream << toJson();
+    } else {
+        stream << toCsv();
+    }
+
+    file.close();
+}
+
+QString PhaseHistory::escapeJson(const QString &string)
+{
+    QString escaped;
+    foreach(QChar character, string) {
+        switch(character.unicode()) {
+        case '"':  escaped.append("\\\""); break;
+        case '\\': escaped.append("\\\\"); break;
+        case '\n': escaped.append("\\n");  break;
+        case '\r': escaped.append("\\r");  break;
+        case '\t': escaped.append("\\t");  break;
+        default:
+            if(character.unicode() < 0x20) {
+                escaped.append(QString("\\u%1").arg(character.unicode(), 4, 16, QChar('0')));
+            } else {
+                escaped.append(character);
+            }
+        }
+    }
+    return escaped;
+}
+
+} // namespace SWAT
+} // namespace Plugins
@@ -0,0 +1,79 @@
+/*!
+   \file PhaseHistory.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef PLUGINS_SWAT_PHASEHISTORY_H
+#define PLUGINS_SWAT_PHASEHISTORY_H
+
+#include <QtCore>
+#include "ConnectionManagerLibrary.h"
+
+namespace Plugins {
+namespace SWAT {
+
+class CONNECTIONMANAGER_EXPORT PhaseHistory : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*! \brief A single timed phase of an adapter operation
+     */
+    struct Entry {
+        QDateTime finished;
+        QString phase;
+        qint64 milliseconds;
+    };
+
+    explicit PhaseHistory(int maximumEntries = 1000, QObject *parent = 0);
+
+    int maximumEntries() const;
+    void setMaximumEntries(int maximumEntries);
+
+    QList<QUuid> ids() const;
+    QList<Entry> entries(const QUuid &id) const;
+    void clear();
+
+    QString toCsv() const;
+    QString toJson() const;
+    void exportToFile(const QString &filename) const;
+
+public slots:
+    void record(QString phase, qint64 milliseconds, QUuid id);
+
+protected:
+    static QString escapeJson(const QString &string);
+
+private:
+    QHash<QUuid, QList<Entry> > m_Entries;
+    int m_MaximumEntries;
+
+};
+
+} // namespace SWAT
+} // namespace Plugins
+
+#endif // PLUGINS_SWAT_PHASEHISTORY_H
@@ -0,0 +1,393 @@
+/*!
+   \file AttributeStore.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "AttributeStore.h"
+
+#include "StringPool.h"
+
+namespace Plugins {
+namespace DirectedGraph {
+
+/*! \class AttributeStore
+    \brief Dense, column-wise store of the node or edge attributes of a graph
+
+    Each attribute type is a column, and each ID a row.  A column is typed: strings are interned in the StringPool,
+    so repeated function and file names cost a handle each, in every scene; integers are kept unboxed; and STAT
+    process lists are kept as rank ranges in one shared buffer.  Rows are found with a single
+    vector index for the usual small, non-negative IDs; IDs far beyond the number of rows stored go through a hash,
+    so one stray large ID doesn't allocate an index up to it.
+
+    The StringPool never lets go of a string, so only symbols that recur from graph to graph belong in a
+    Column_String.  Text that is particular to one graph, such as labels carrying process lists, goes in a
+    Column_Text, which is freed along with the store.
+
+    value() and setValue() convert to and from QVariant for the generic accessors; the typed accessors don't box
+    anything.  A value that doesn't fit its column, or a type with no column defined, is kept as a QVariant.
+ */
+
+//! IDs below this are indexed directly; STAT numbers its frames from 0
+static const qint64 maximumDenseId = Q_INT64_C(1) << 22;
+
+//! The direct index only grows to this many slots per stored row, or minimumDenseIds, whichever is larger
+static const qint64 denseIdsPerRow = 4;
+static const qint64 minimumDenseIds = 1024;
+
+AttributeStore::AttributeStore() :
+    m_RowCount(0)
+{
+}
+
+/*! \fn AttributeStore::defineColumn()
+    \brief Sets how values of an attribute type are kept; any values already stored for it are dropped
+ */
+void AttributeStore::defineColumn(int type, ColumnType columnType)
+{
+    if(type < 0) {
+        return;
+    }
+
+    if(type >= m_Columns.count()) {
+        m_Columns.resize(type + 1);
+    }
+
+    Column column;
+    column.type = columnType;
+    m_Columns[type] = column;
+}
+
+/*! \fn AttributeStore::row()
+    \returns Row of the ID, or -1 if nothing has been stored for it
+ */
+int AttributeStore::row(qint64 id) const
+{
+    if(id >= 0 && id < m_DenseRows.count()) {
+        int row = m_DenseRows.at((int)id);
+
+        // The index may have grown past an ID that was stored before it was in reach
+        if(row >= 0 || m_SparseRows.isEmpty()) {
+            return row;
+        }
+    }
+
+    return m_SparseRows.value(id, -1);
+}
+
+int AttributeStore::insertRow(qint64 id)
+{
+    int row = this->row(id);
+    if(row >= 0) {
+        return row;
+    }
+
+    row = m_RowCount++;
+
+    qint64 denseIds = qMin(qMax(denseIdsPerRow * m_RowCount, minimumDenseIds), maximumDenseId);
+    if(id >= 0 && (id < m_DenseRows.count() || id < denseIds)) {
+        if(id >= m_DenseRows.count()) {
+            int first = m_DenseRows.count();
+            m_DenseRows.resize((int)id + 1);
+            for(int i = first; i < m_DenseRows.count(); ++i) {
+                m_DenseRows[i] = -1;
+            }
+        }
+        m_DenseRows[(int)id] = row;
+    } else {
+        m_SparseRows.insert(id, row);
+    }
+
+    return row;
+}
+
+/*! \fn AttributeStore::column()
+    \returns Column of the attribute type, or NULL if the row holds no value in it
+ */
+const AttributeStore::Column *AttributeStore::column(int row, int type) const
+{
+    if(row < 0 || type < 0 || type >= m_Columns.count()) {
+        return NULL;
+    }
+
+    const Column &column = m_Columns.at(type);
+    if(row >= column.present.size() || !column.present.testBit(row)) {
+        return NULL;
+    }
+
+    return &column;
+}
+
+/*! \fn AttributeStore::setRankSet()
+    \brief Keeps a process list as rank ranges; the row's previous ranges are overwritten if the new ones fit
+    \returns False if the list wouldn't read back exactly as it was given
+ */
+bool AttributeStore::setRankSet(Column &column, int row, const QStringList &processList)
+{
+    QVarLengthArray<quint64, 32> ranks;
+    RankSet rankSet;
+
+    for(int i = 0; i < processList.count(); ++i) {
+        const QString &processes = processList.at(i);
+
+        // A truncated list ends with an ellipsis
+        if(processes == "..." && i == processList.count() - 1) {
+            rankSet.truncated = true;
+            break;
+        }
+
+        bool okay = false;
+        quint64 first = 0, last = 0;
+
+        int dash = processes.indexOf('-');
+        if(dash < 0) {
+            first = last = processes.toULongLong(&okay);
+            okay = okay && (QString::number(first) == processes);
+        } else {
+            first = processes.left(dash).toULongLong(&okay);
+            if(okay) {
+                last = processes.mid(dash + 1).toULongLong(&okay);
+            }
+            okay = okay && first < last && (QString("%1-%2").arg(first).arg(last) == processes);
+        }
+
+        if(!okay) {
+            return false;
+        }
+
+        ranks.append(first);
+        ranks.append(last);
+        ++rankSet.count;
+    }
+
+    if(column.rankSets.count() <= row) {
+        column.rankSets.resize(row + 1);
+    }
+
+    // A row that is set again reuses its old ranges, rather than leaving them behind in the buffer
+    const RankSet &previous = column.rankSets.at(row);
+    if(rankSet.count > 0 && rankSet.count <= previous.count) {
+        rankSet.offset = previous.offset;
+    } else {
+        rankSet.offset = m_Ranks.count();
+        m_Ranks.resize(m_Ranks.count() + ranks.count());
+    }
+    if(!ranks.isEmpty()) {
+        qCopy(ranks.constData(), ranks.constData() + ranks.count(), m_Ranks.data() + rankSet.offset);
+    }
+
+    column.rankSets[row] = rankSet;
+
+    return true;
+}
+
+/*! \fn AttributeStore::setValue()
+    \brief Stores an attribute of an ID, converting it to its column's type
+ */
+void AttributeStore::setValue(qint64 id, int type, const QVariant &value)
+{
+    if(type < 0) {
+        return;
+    }
+
+    if(type >= m_Columns.count() || m_Columns.at(type).type == Column_None) {
+        defineColumn(type, Column_Variant);
+    }
+
+    int row = insertRow(id);
+    Column &column = m_Columns[type];
+
+    if(column.present.size() <= row) {
+        column.present.resize(row + 1);
+    }
+    column.present.setBit(row);
+    column.overflow.remove(row);
+
+    bool stored = false;
+
+    switch(column.type) {
+    case Column_String:
+        if(value.type() == QVariant::String) {
+            if(column.strings.count() <= row) {
+                column.strings.resize(row + 1);
+            }
+            column.strings[row] = StringPool::instance().intern(value.toString());
+            stored = true;
+        }
+        break;
+    case Column_Text:
+        if(value.type() == QVariant::String) {
+            if(column.texts.count() <= row) {
+                column.texts.resize(row + 1);
+            }
+            column.texts[row] = value.toString();
+            stored = true;
+        }
+        break;
+    case Column_Integer:
+        if(value.type() == QVariant::UInt || value.type() == QVariant::ULongLong ||
+                ((value.type() == QVariant::Int || value.type() == QVariant::LongLong) && value.toLongLong() >= 0)) {
+            if(column.integers.count() <= row) {
+                column.integers.resize(row + 1);
+            }
+            column.integers[row] = value.toULongLong();
+            stored = true;
+        }
+        break;
+    case Column_RankSet:
+        if(value.type() == QVariant::StringList) {
+            stored = setRankSet(column, row, value.toStringList());
+        }
+        break;
+    default:
+        if(column.variants.count() <= row) {
+            column.variants.resize(row + 1);
+        }
+        column.variants[row] = value;
+        stored = true;
+        break;
+    }
+
+    if(!stored) {
+        column.overflow.insert(row, value);
+    }
+}
+
+/*! \fn AttributeStore::value()
+    \returns Attribute of an ID as a QVariant, or defaultValue if it was never set
+ */
+QVariant AttributeStore::value(qint64 id, int type, const QVariant &defaultValue) const
+{
+    int row = this->row(id);
+    const Column *column = this->column(row, type);
+    if(!column) {
+        return defaultValue;
+    }
+
+    if(!column->overflow.isEmpty() && column->overflow.contains(row)) {
+        return column->overflow.value(row);
+    }
+
+    switch(column->type) {
+    case Column_String:
+        return StringPool::instance().string(column->strings.at(row));
+    case Column_Text:
+        return column->texts.at(row);
+    case Column_Integer:
+        return column->integers.at(row);
+    case Column_RankSet:
+        return rankList(id, type);
+    default:
+        return column->variants.at(row);
+    }
+}
+
+/*! \fn AttributeStore::string()
+    \returns Attribute of an ID as a string, or an empty string if it was never set
+ */
+QString AttributeStore::string(qint64 id, int type) const
+{
+    int row = this->row(id);
+    const Column *column = this->column(row, type);
+    if(!column) {
+        return QString();
+    }
+
+    if(column->overflow.isEmpty() || !column->overflow.contains(row)) {
+        if(column->type == Column_String) {
+            return StringPool::instance().string(column->strings.at(row));
+        } else if(column->type == Column_Text) {
+            return column->texts.at(row);
+        }
+    }
+
+    return value(id, type).toString();
+}
+
+/*! \fn AttributeStore::stringId()
+    \returns StringPool handle of a string attribute, or 0 (the empty string) if it was never set or isn't interned
+ */
+quint32 AttributeStore::stringId(qint64 id, int type) const
+{
+    int row = this->row(id);
+    const Column *column = this->column(row, type);
+    if(!column || column->type != Column_String || (!column->overflow.isEmpty() && column->overflow.contains(row))) {
+        return 0;
+    }
+
+    return column->strings.at(row);
+}
+
+/*! \fn AttributeStore::integer()
+    \returns Attribute of an ID as an unsigned integer, or defaultValue if it was never set
+ */
+quint64 AttributeStore::integer(qint64 id, int type, quint64 defaultValue) const
+{
+    int row = this->row(id);
+    const Column *column = this->column(row, type);
+    if(!column) {
+        return defaultValue;
+    }
+
+    if(column->type == Column_Integer && (column->overflow.isEmpty() || !column->overflow.contains(row))) {
+        return column->integers.at(row);
+    }
+
+    return value(id, type).toULongLong();
+}
+
+/*! \fn AttributeStore::rankList()
+    \returns Process list attribute of an ID, written back out as STAT wrote it
+ */
+QStringList AttributeStore::rankList(qint64 id, int type) const
+{
+    int row = this->row(id);
+    const Column *column = this->column(row, type);
+    if(!column) {
+        return QStringList();
+    }
+
+    if(column->type != Column_RankSet || (!column->overflow.isEmpty() && column->overflow.contains(row))) {
+        return value(id, type).toStringList();
+    }
+
+    const RankSet &rankSet = column->rankSets.at(row);
+
+    QStringList retval;
+    for(quint32 i = 0; i < rankSet.count; ++i) {
+        quint64 first = m_Ranks.at(rankSet.offset + (i * 2));
+        quint64 last = m_Ranks.at(rankSet.offset + (i * 2) + 1);
+        retval << ((first == last) ? QString::number(first) : QString("%1-%2").arg(first).arg(last));
+    }
+
+    if(rankSet.truncated) {
+        retval << "...";
+    }
+
+    return retval;
+}
+
+} // namespace DirectedGraph
+} // namespace Plugins
@@ -0,0 +1,103 @@
+/*!
+   \file AttributeStore.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef PLUGINS_DIRECTEDGRAPH_ATTRIBUTESTORE_H
+#define PLUGINS_DIRECTEDGRAPH_ATTRIBUTESTORE_H
+
+#include <QtCore>
+
+namespace Plugins {
+namespace DirectedGraph {
+
+class AttributeStore
+{
+public:
+    enum ColumnType {
+        Column_None = 0,
+        Column_Variant,     //!< Anything; kept as a QVariant
+        Column_String,      //!< Strings, kept as handles into the process wide StringPool
+        Column_Text,        //!< Strings, kept in the store itself
+        Column_Integer,     //!< Unsigned integers, such as line numbers and program counters
+        Column_RankSet      //!< STAT process lists ("0-3", "7", "..."), kept as rank ranges
+    };
+
+    AttributeStore();
+
+    void defineColumn(int type, ColumnType columnType);
+
+    void setValue(qint64 id, int type, const QVariant &value);
+    QVariant value(qint64 id, int type, const QVariant &defaultValue = QVariant()) const;
+
+    QString string(qint64 id, int type) const;
+    quint32 stringId(qint64 id, int type) const;
+    quint64 integer(qint64 id, int type, quint64 defaultValue = 0) const;
+    QStringList rankList(qint64 id, int type) const;
+
+protected:
+    //! Where a row's rank set lives in m_Ranks; ranges are stored as first/last pairs
+    struct RankSet {
+        RankSet() : offset(0), count(0), truncated(false) {}
+        quint32 offset;
+        quint32 count;
+        bool truncated;
+    };
+
+    struct Column {
+        Column() : type(Column_None) {}
+        ColumnType type;
+        QBitArray present;
+        QVector<QVariant> variants;
+        QVector<quint32> strings;
+        QVector<QString> texts;
+        QVector<quint64> integers;
+        QVector<RankSet> rankSets;
+
+        //! Values that don't fit the column's type, kept as they were given
+        QHash<int, QVariant> overflow;
+    };
+
+    int row(qint64 id) const;
+    int insertRow(qint64 id);
+    const Column *column(int row, int type) const;
+    bool setRankSet(Column &column, int row, const QStringList &processList);
+
+private:
+    //! Row of each ID; IDs from 0 up to a few times the row count are indexed directly, anything else through the hash
+    QVector<int> m_DenseRows;
+    QHash<qint64, int> m_SparseRows;
+    int m_RowCount;
+
+    QVector<Column> m_Columns;
+
+    QVector<quint64> m_Ranks;
+};
+
+} // namespace DirectedGraph
+} // namespace Plugins
+
+#endif // PLUGINS_DIRECTEDGRAPH_ATTRIBUTESTORE_H
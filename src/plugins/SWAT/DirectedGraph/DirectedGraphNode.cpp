@@ -65,22 +65,22 @@ const int &DirectedGraphNode::nodeDepth()
 
 QString DirectedGraphNode::label()
 {
-    return m_Scene->nodeInfo(nodeId(), DirectedGraphScene::NodeInfoType_LongLabel).toString();
+    return m_Scene->nodeAttributes().string(nodeId(), DirectedGraphScene::NodeInfoType_LongLabel);
 }
 
 QString DirectedGraphNode::shortLabel()
 {
-    return m_Scene->nodeInfo(nodeId(), DirectedGraphScene::NodeInfoType_ShortLabel).toString();
+    return m_Scene->nodeAttributes().string(nodeId(), DirectedGraphScene::NodeInfoType_ShortLabel);
 }
 
 QString DirectedGraphNode::edgeLabel()
 {
-    return m_Scene->edgeInfo(nodeId(), DirectedGraphScene::EdgeInfoType_LongLabel).toString();
+    return m_Scene->edgeAttributes().string(nodeId(), DirectedGraphScene::EdgeInfoType_LongLabel);
 }
 
 QString DirectedGraphNode::shortEdgeLabel()
 {
-    return m_Scene->edgeInfo(nodeId(), DirectedGraphScene::EdgeInfoType_ShortLabel).toString();
+    return m_Scene->edgeAttributes().string(nodeId(), DirectedGraphScene::EdgeInfoType_ShortLabel);
 }
 
 DirectedGraphNode *DirectedGraphNode::parentNode()
@@ -36,6 +36,10 @@ namespace DirectedGraph {
 DirectedGraphScene::DirectedGraphScene(QObject *parent) :
     QGraphVizScene(parent)
 {
+    defineNodeInfo(NodeInfoType_LongLabel, AttributeStore::Column_Text);
+    defineNodeInfo(NodeInfoType_ShortLabel, AttributeStore::Column_Text);
+    defineEdgeInfo(EdgeInfoType_LongLabel, AttributeStore::Column_Text);
+    defineEdgeInfo(EdgeInfoType_ShortLabel, AttributeStore::Column_Text);
 }
 
 void DirectedGraphScene::setContent(const QString &content)
@@ -53,48 +57,35 @@ QGraphVizEdge *DirectedGraphScene::createEdge(edge_t *edge)
     return new DirectedGraphEdge(edge, this);
 }
 
+/*! \fn DirectedGraphScene::preprocessContent()
+    \brief Decodes every node and edge label, and shortens them for layout
+ */
 QString DirectedGraphScene::preprocessContent(const QString &content)
 {
-    if(content.isEmpty()) {
-        return QString();
-    }
-
-    QString retval;
-
-    QRegExp rxLabel = QRegExp("label=\"(.*)\"", Qt::CaseInsensitive);
-    rxLabel.setMinimal(true);  // non-greedy
-
-    QRegExp rxNode = QRegExp("^\\s+([0-9\\-]+)\\s\\[.*fillcolor.*\\]", Qt::CaseInsensitive, QRegExp::RegExp2);
-    QRegExp rxEdge = QRegExp("^\\s+([0-9\\-]+)\\s->\\s([0-9\\-]+)\\s\\[.*\\]", Qt::CaseInsensitive, QRegExp::RegExp2);
-
-    foreach(QString line, content.split('\n')) {
-        if(rxNode.indexIn(line) >= 0 && rxNode.captureCount() == 1) {           // Is node
-            if(rxLabel.indexIn(line) >= 0 && rxLabel.captureCount() == 1) {     // With label
-                QString label = rxLabel.cap(1);
-                qint64 id = rxNode.cap(1).toLongLong();
-
-                processNodeLabel(id, label);
-
-                line = line.replace(label, nodeInfo(id, NodeInfoType_ShortLabel).toString());
-            }
-        } else if(rxEdge.indexIn(line) >= 0 && rxEdge.captureCount() == 2) {    // Is edge
-            if(rxLabel.indexIn(line) >= 0 && rxLabel.captureCount() == 1) {     // With label
-                QString label = rxLabel.cap(1);
-                qint64 id = rxEdge.cap(2).toLongLong();
-
-                processEdgeLabel(id, label);
-
-                line = line.replace(label, edgeInfo(id, EdgeInfoType_ShortLabel).toString());
-            }
-        }
+    return preprocess(content);
+}
 
-        retval += line;
-    }
+/*! \fn DirectedGraphScene::processNodeLabel()
+    \brief Decodes a single node label into the node's information
+ */
+void DirectedGraphScene::processNodeLabel(const qint64 &id, const QString &label)
+{
+    storeNodeLabel(id, decodeNodeLabel(label));
+}
 
-    return retval;
+/*! \fn DirectedGraphScene::processEdgeLabel()
+    \brief Decodes a single edge label into the edge's information
+ */
+void DirectedGraphScene::processEdgeLabel(const qint64 &id, const QString &label)
+{
+    storeEdgeLabel(id, decodeEdgeLabel(label));
 }
 
-void DirectedGraphScene::processNodeLabel(const qint64 &id, const QString &label)
+/*! \fn DirectedGraphScene::decodeNodeLabel()
+    \returns Node information held by the label; at least NodeInfoType_LongLabel and NodeInfoType_ShortLabel
+    \note Called from pool threads while loading; overrides mustn't touch the scene
+ */
+DirectedGraphScene::Attributes DirectedGraphScene::decodeNodeLabel(const QString &label) const
 {
     static const quint8 maxNodeLabelSize = 64;
 
@@ -103,11 +94,17 @@ void DirectedGraphScene::processNodeLabel(const qint64 &id, const QString &label
         shortLabel = "..." + shortLabel.right(maxNodeLabelSize - 3);
     }
 
-    setNodeInfo(id, NodeInfoType_LongLabel, label);
-    setNodeInfo(id, NodeInfoType_ShortLabel, shortLabel);
+    Attributes attributes;
+    attributes.insert(NodeInfoType_LongLabel, label);
+    attributes.insert(NodeInfoType_ShortLabel, shortLabel);
+    return attributes;
 }
 
-void DirectedGraphScene::processEdgeLabel(const qint64 &id, const QString &label)
+/*! \fn DirectedGraphScene::decodeEdgeLabel()
+    \returns Edge information held by the label; at least EdgeInfoType_LongLabel and EdgeInfoType_ShortLabel
+    \note Called from pool threads while loading; overrides mustn't touch the scene
+ */
+DirectedGraphScene::Attributes DirectedGraphScene::decodeEdgeLabel(const QString &label) const
 {
     static const quint8 maxEdgeLabelSize = 24;
 
@@ -116,43 +113,85 @@ void DirectedGraphScene::processEdgeLabel(const qint64 &id, const QString &label
         shortLabel = shortLabel.left(maxEdgeLabelSize - 3) + "...";
     }
 
-    setEdgeInfo(id, EdgeInfoType_LongLabel, label);
-    setEdgeInfo(id, EdgeInfoType_ShortLabel, shortLabel);
+    Attributes attributes;
+    attributes.insert(EdgeInfoType_LongLabel, label);
+    attributes.insert(EdgeInfoType_ShortLabel, shortLabel);
+    return attributes;
 }
 
+QString DirectedGraphScene::storeNodeLabel(const qint64 &id, const Attributes &attributes)
+{
+    QHashIterator<int, QVariant> iterator(attributes);
+    while(iterator.hasNext()) {
+        iterator.next();
+        setNodeInfo(id, iterator.key(), iterator.value());
+    }
+
+    return m_NodeAttributes.string(id, NodeInfoType_ShortLabel);
+}
+
+QString DirectedGraphScene::storeEdgeLabel(const qint64 &id, const Attributes &attributes)
+{
+    QHashIterator<int, QVariant> iterator(attributes);
+    while(iterator.hasNext()) {
+        iterator.next();
+        setEdgeInfo(id, iterator.key(), iterator.value());
+    }
+
+    return m_EdgeAttributes.string(id, EdgeInfoType_ShortLabel);
+}
+
+
+/*! \fn DirectedGraphScene::defineNodeInfo()
+    \brief Sets how a type of node information is kept; subclasses define their own types in their constructors
+ */
+void DirectedGraphScene::defineNodeInfo(const int &type, AttributeStore::ColumnType columnType)
+{
+    m_NodeAttributes.defineColumn(type, columnType);
+}
+
+/*! \fn DirectedGraphScene::defineEdgeInfo()
+    \brief Sets how a type of edge information is kept; subclasses define their own types in their constructors
+ */
+void DirectedGraphScene::defineEdgeInfo(const int &type, AttributeStore::ColumnType columnType)
+{
+    m_EdgeAttributes.defineColumn(type, columnType);
+}
 
 void DirectedGraphScene::setNodeInfo(const qint64 &id, const int &type, const QVariant &value)
 {
-    m_NodeInfos[id][type] = value;
+    m_NodeAttributes.setValue(id, type, value);
 }
 
 QVariant DirectedGraphScene::nodeInfo(const qint64 &id, const int &type, const QVariant &defaultValue) const
 {
-    if(m_NodeInfos.contains(id)) {
-        info nodeInfo = m_NodeInfos.value(id);
-        if(nodeInfo.contains(type)) {
-            return nodeInfo.value(type);
-        }
-    }
-
-    return defaultValue;
+    return m_NodeAttributes.value(id, type, defaultValue);
 }
 
 void DirectedGraphScene::setEdgeInfo(const qint64 &id, const int &type, const QVariant &value)
 {
-    m_EdgeInfos[id][type] = value;
+    m_EdgeAttributes.setValue(id, type, value);
 }
 
 QVariant DirectedGraphScene::edgeInfo(const qint64 &id, const int &type, const QVariant &defaultValue) const
 {
-    if(m_EdgeInfos.contains(id)) {
-        info edgeInfo = m_EdgeInfos.value(id);
-        if(edgeInfo.contains(type)) {
-            return edgeInfo.value(type);
-        }
-    }
+    return m_EdgeAttributes.value(id, type, defaultValue);
+}
 
-    return defaultValue;
+/*! \fn DirectedGraphScene::nodeAttributes()
+    \returns Node information, for typed access without boxing each value in a QVariant
+ */
+const AttributeStore &DirectedGraphScene::nodeAttributes() const
+{
+    return m_NodeAttributes;
+}
+
+/*! \fn DirectedGraphScene::edgeAttributes()
+    \returns Edge information, keyed by the ID of each edge's head node
+ */
+const AttributeStore &DirectedGraphScene::edgeAttributes() const
+{
+    return m_EdgeAttributes;
 }
 
 } // namespace DirectedGraph
@@ -33,10 +33,13 @@
 
 #include <QGraphVizScene.h>
 
+#include "DotPreprocessor.h"
+#include "AttributeStore.h"
+
 namespace Plugins {
 namespace DirectedGraph {
 
-class DirectedGraphScene : public QGraphVizScene
+class DirectedGraphScene : public QGraphVizScene, protected DotPreprocessor
 {
     Q_OBJECT
 public:
@@ -47,6 +50,9 @@ public:
     QVariant nodeInfo(const qint64 &id, const int &type, const QVariant &defaultValue = QVariant()) const;
     QVariant edgeInfo(const qint64 &id, const int &type, const QVariant &defaultValue = QVariant()) const;
 
+    const AttributeStore &nodeAttributes() const;
+    const AttributeStore &edgeAttributes() const;
+
 protected:
     enum NodeInfoTypes {
         NodeInfoType_LongLabel = 0,
@@ -62,16 +68,23 @@ protected:
     virtual void processNodeLabel(const qint64 &id, const QString &label);
     virtual void processEdgeLabel(const qint64 &id, const QString &label);
 
+    virtual Attributes decodeNodeLabel(const QString &label) const;
+    virtual Attributes decodeEdgeLabel(const QString &label) const;
+    QString storeNodeLabel(const qint64 &id, const Attributes &attributes);
+    QString storeEdgeLabel(const qint64 &id, const Attributes &attributes);
+
     QGraphVizNode *createNode(node_t *node);
     QGraphVizEdge *createEdge(edge_t *edge);
 
     void setNodeInfo(const qint64 &id, const int &type, const QVariant &value);
     void setEdgeInfo(const qint64 &id, const int &type, const QVariant &value);
 
+    void defineNodeInfo(const int &type, AttributeStore::ColumnType columnType);
+    void defineEdgeInfo(const int &type, AttributeStore::ColumnType columnType);
+
 private:
-    typedef QHash<int, QVariant> info;
-    QHash<qint64, info> m_NodeInfos;
-    QHash<qint64, info> m_EdgeInfos;
+    AttributeStore m_NodeAttributes;
+    AttributeStore m_EdgeAttributes;
 
     friend class DirectedGraphNode;
     friend class DirectedGraphEdge;
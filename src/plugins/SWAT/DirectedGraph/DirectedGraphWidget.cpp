@@ -222,6 +222,30 @@ DirectedGraphScene *DirectedGraphWidget::createScene(const QByteArray &content)
     return m_Scene;
 }
 
+/*! \fn DirectedGraphWidget::replaceScene()
+    \brief Shows a newly built scene in the existing view, keeping the zoom and the point the view is centered on
+    \param scene Scene to show; the caller is responsible for the old one
+ */
+void DirectedGraphWidget::replaceScene(DirectedGraphScene *scene)
+{
+    // Commands on the stack refer to the nodes of the old scene
+    m_UndoStack->clear();
+
+    // Subclasses creating their own scenes keep track of them themselves
+    if(m_Scene) {
+        m_Scene = scene;
+    }
+
+    if(!m_View) {
+        return;
+    }
+
+    QPointF center = m_View->mapToScene(m_View->viewport()->rect().center());
+    m_View->setScene(scene);
+    scene->setParent(this);
+    m_View->centerOn(center);
+}
+
 DirectedGraphScene *DirectedGraphWidget::scene() const
 {
     return m_Scene;
@@ -147,6 +147,7 @@ protected:
     const QUuid &id() const;
     QUndoStack *undoStack() const;
     virtual DirectedGraphScene *createScene(const QByteArray &content);
+    void replaceScene(DirectedGraphScene *scene);
     virtual void showEvent(QShowEvent *event);
     virtual void hideEvent(QHideEvent *event);
     virtual void resizeEvent(QResizeEvent *event);
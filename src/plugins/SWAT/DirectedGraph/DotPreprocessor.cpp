@@ -0,0 +1,369 @@
+/*!
+   \file DotPreprocessor.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "DotPreprocessor.h"
+
+namespace Plugins {
+namespace DirectedGraph {
+
+/*! \class DotPreprocessor
+    \brief Finds every node and edge label in STAT's DOT output, decodes them, and replaces them with whatever the
+           subclass makes of them
+
+    Preprocessing runs in three phases:
+    \li scan() walks the characters once, and records where each labeled node and edge is.  The records are
+        recognized exactly as the regular expressions this replaces did:
+    \code
+    node:  ^\s+([0-9\-]+)\s\[.*fillcolor.*\]
+    edge:  ^\s+([0-9\-]+)\s->\s([0-9\-]+)\s\[.*\]
+    label: label="(.*?)"
+    \endcode
+        but with a hand written scanner that never backtracks or copies a line.
+    \li The labels are decoded with decodeNodeLabel() and decodeEdgeLabel().  Each label is independent of the
+        others, so on large graphs they are decoded in chunks across the global thread pool.
+    \li The attributes are handed to storeNodeLabel() and storeEdgeLabel() in file order, on the calling thread, and
+        the content is copied into a buffer reserved at its size, with each label replaced by what they return.
+ */
+
+//! Fewer records than this are decoded on the calling thread; spreading them isn't worth the overhead
+static const int minimumConcurrentRecords = 512;
+
+//! Smallest number of records decoded together on a pool thread
+static const int minimumChunkSize = 128;
+
+DotPreprocessor::DotPreprocessor() :
+    m_ConcurrentDecode(true)
+{
+}
+
+/*! \fn DotPreprocessor::concurrentDecode()
+    \returns True if large graphs have their labels decoded across the global thread pool (the default)
+ */
+bool DotPreprocessor::concurrentDecode() const
+{
+    return m_ConcurrentDecode;
+}
+
+void DotPreprocessor::setConcurrentDecode(bool concurrent)
+{
+    m_ConcurrentDecode = concurrent;
+}
+
+/*! \fn DotPreprocessor::preprocess()
+    \returns Content with the node and edge labels replaced
+ */
+QString DotPreprocessor::preprocess(const QString &content)
+{
+    if(content.isEmpty()) {
+        return QString();
+    }
+
+    QVector<Record> records = scan(content);
+
+    QVector<Attributes> attributes(records.count());
+    decode(content, records, attributes);
+
+    QString retval;
+    retval.reserve(content.size());
+
+    int copied = 0;
+    for(int i = 0; i < records.count(); ++i) {
+        const Record &record = records.at(i);
+
+        QString replacement = (record.type == Record_Node) ? storeNodeLabel(record.id, attributes.at(i))
+                                                           : storeEdgeLabel(record.id, attributes.at(i));
+
+        retval.append(QStringRef(&content, copied, record.labelBegin - copied));
+        retval.append(replacement);
+        copied = record.labelEnd;
+    }
+
+    retval.append(QStringRef(&content, copied, content.size() - copied));
+
+    return retval;
+}
+
+/*! \fn DotPreprocessor::scan()
+    \returns Every labeled node and edge statement in the content, in file order
+ */
+QVector<DotPreprocessor::Record> DotPreprocessor::scan(const QString &content)
+{
+    QVector<Record> records;
+
+    const QChar *data = content.constData();
+    const int size = content.size();
+
+    int begin = 0;
+    while(begin < size) {
+        int end = begin;
+        while(end < size && data[end] != QLatin1Char('\n')) {
+            ++end;
+        }
+
+        Record record;
+        if(parseRecord(data, begin, end, &record) && findLabel(data, begin, end, &record.labelBegin, &record.labelEnd)) {
+            records.append(record);
+        }
+
+        begin = end + 1;
+    }
+
+    return records;
+}
+
+/*! \fn DotPreprocessor::decode()
+    \brief Decodes the label of every record into the matching entry of attributes
+ */
+void DotPreprocessor::decode(const QString &content, const QVector<Record> &records, QVector<Attributes> &attributes) const
+{
+    DecodeChunk whole;
+    whole.preprocessor = this;
+    whole.data = content.constData();
+    whole.records = records.constData();
+    whole.attributes = attributes.data();
+    whole.count = records.count();
+
+    if(!m_ConcurrentDecode || whole.count < minimumConcurrentRecords) {
+        decodeChunk(whole);
+        return;
+    }
+
+    // A few chunks per thread, so that a slow chunk doesn't hold up the others
+    int chunkSize = qMax(minimumChunkSize, whole.count / (QThread::idealThreadCount() * 4));
+
+    QList<DecodeChunk> chunks;
+    for(int first = 0; first < whole.count; first += chunkSize) {
+        DecodeChunk chunk = whole;
+        chunk.records += first;
+        chunk.attributes += first;
+        chunk.count = qMin(chunkSize, whole.count - first);
+        chunks.append(chunk);
+    }
+
+    // Each chunk writes only its own slice of the attributes
+    QtConcurrent::blockingMap(chunks, decodeChunk);
+}
+
+/*! \fn DotPreprocessor::decodeChunk()
+    \brief Decodes a run of records; runs on a pool thread
+ */
+void DotPreprocessor::decodeChunk(DecodeChunk &chunk)
+{
+    for(int i = 0; i < chunk.count; ++i) {
+        const Record &record = chunk.records[i];
+        QString label(chunk.data + record.labelBegin, record.labelEnd - record.labelBegin);
+
+        chunk.attributes[i] = (record.type == Record_Node) ? chunk.preprocessor->decodeNodeLabel(label)
+                                                           : chunk.preprocessor->decodeEdgeLabel(label);
+    }
+}
+
+/*! \fn DotPreprocessor::parseRecord()
+    \brief Recognizes a node or edge statement on the line [begin, end)
+    \param record Set to the statement's type, IDs and their positions; the label is left to findLabel()
+    \returns False if the line is neither
+ */
+bool DotPreprocessor::parseRecord(const QChar *data, int begin, int end, Record *record)
+{
+    int i = begin;
+
+    // Indented
+    while(i < end && data[i].isSpace()) {
+        ++i;
+    }
+    if(i == begin) {
+        return false;
+    }
+
+    // ID
+    int idBegin = i;
+    while(i < end && ((data[i] >= QLatin1Char('0') && data[i] <= QLatin1Char('9')) || data[i] == QLatin1Char('-'))) {
+        ++i;
+    }
+    if(i == idBegin || i >= end || !data[i].isSpace()) {
+        return false;
+    }
+    int idEnd = i++;
+
+    if(i < end && data[i] == QLatin1Char('[')) {
+        // Node; it needs a fill color, followed somewhere by a closing bracket
+        int fillColor = indexOf(data, i + 1, end, "fillcolor");
+        if(fillColor < 0) {
+            return false;
+        }
+
+        int closing = end - 1;
+        while(closing >= fillColor + 9 && data[closing] != QLatin1Char(']')) {
+            --closing;
+        }
+        if(closing < fillColor + 9) {
+            return false;
+        }
+
+        record->type = Record_Node;
+        record->id = toId(data, idBegin, idEnd);
+        record->tail = 0;
+        record->idBegin = idBegin;
+        record->idEnd = idEnd;
+        record->tailBegin = record->tailEnd = -1;
+        record->lineBegin = begin;
+        record->lineEnd = end;
+        return true;
+    }
+
+    // Edge; tail ID, arrow, head ID and an attribute list
+    if(i + 1 >= end || data[i] != QLatin1Char('-') || data[i + 1] != QLatin1Char('>')) {
+        return false;
+    }
+    i += 2;
+
+    if(i >= end || !data[i].isSpace()) {
+        return false;
+    }
+    ++i;
+
+    int headBegin = i;
+    while(i < end && ((data[i] >= QLatin1Char('0') && data[i] <= QLatin1Char('9')) || data[i] == QLatin1Char('-'))) {
+        ++i;
+    }
+    if(i == headBegin || i >= end || !data[i].isSpace()) {
+        return false;
+    }
+    int headEnd = i++;
+
+    if(i >= end || data[i] != QLatin1Char('[')) {
+        return false;
+    }
+
+    int closing = end - 1;
+    while(closing > i && data[closing] != QLatin1Char(']')) {
+        --closing;
+    }
+    if(closing <= i) {
+        return false;
+    }
+
+    record->type = Record_Edge;
+    record->id = toId(data, headBegin, headEnd);
+    record->tail = toId(data, idBegin, idEnd);
+    record->idBegin = headBegin;
+    record->idEnd = headEnd;
+    record->tailBegin = idBegin;
+    record->tailEnd = idEnd;
+    record->lineBegin = begin;
+    record->lineEnd = end;
+    return true;
+}
+
+/*! \fn DotPreprocessor::findLabel()
+    \brief Finds the value of the first label attribute on the line [begin, end)
+    \param labelBegin Set to the first character of the value
+    \param labelEnd Set to the closing quote
+ */
+bool DotPreprocessor::findLabel(const QChar *data, int begin, int end, int *labelBegin, int *labelEnd)
+{
+    int label = indexOf(data, begin, end, "label=\"");
+    if(label < 0) {
+        return false;
+    }
+
+    int i = label + 7;
+    int valueBegin = i;
+    while(i < end && data[i] != QLatin1Char('"')) {
+        ++i;
+    }
+    if(i >= end) {
+        return false;
+    }
+
+    *labelBegin = valueBegin;
+    *labelEnd = i;
+    return true;
+}
+
+/*! \fn DotPreprocessor::indexOf()
+    \brief Case insensitive search for ASCII text, bounded to [begin, end)
+    \returns Position of the first match, or -1
+ */
+int DotPreprocessor::indexOf(const QChar *data, int begin, int end, const char *text)
+{
+    const int length = qstrlen(text);
+    const int last = end - length;
+
+    for(int i = begin; i <= last; ++i) {
+        int j = 0;
+        while(j < length) {
+            ushort c = data[i + j].unicode();
+            if(c >= 'A' && c <= 'Z') {
+                c += 'a' - 'A';
+            }
+            if(c != (ushort)text[j]) {
+                break;
+            }
+            ++j;
+        }
+
+        if(j == length) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/*! \fn DotPreprocessor::toId()
+    \returns Value of the ID in [begin, end), or 0 if it isn't a number; as QString::toLongLong() would
+ */
+qint64 DotPreprocessor::toId(const QChar *data, int begin, int end)
+{
+    int i = begin;
+
+    bool negative = false;
+    if(i < end && data[i] == QLatin1Char('-')) {
+        negative = true;
+        ++i;
+    }
+
+    if(i >= end) {
+        return 0;
+    }
+
+    qint64 value = 0;
+    for(; i < end; ++i) {
+        ushort c = data[i].unicode();
+        if(c < '0' || c > '9') {
+            return 0;
+        }
+        value = (value * 10) + (c - '0');
+    }
+
+    return negative ? -value : value;
+}
+
+} // namespace DirectedGraph
+} // namespace Plugins
@@ -0,0 +1,125 @@
+/*!
+   \file DotPreprocessor.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef PLUGINS_DIRECTEDGRAPH_DOTPREPROCESSOR_H
+#define PLUGINS_DIRECTEDGRAPH_DOTPREPROCESSOR_H
+
+#include <QtCore>
+
+namespace Plugins {
+namespace DirectedGraph {
+
+class DotPreprocessor
+{
+public:
+    DotPreprocessor();
+    virtual ~DotPreprocessor() {}
+
+    QString preprocess(const QString &content);
+
+    bool concurrentDecode() const;
+    void setConcurrentDecode(bool concurrent);
+
+protected:
+    typedef QHash<int, QVariant> Attributes;
+
+    /*! \fn DotPreprocessor::decodeNodeLabel()
+        \brief Decodes a node label into its attributes
+        \note Runs on pool threads alongside other calls; it mustn't change any shared state
+     */
+    virtual Attributes decodeNodeLabel(const QString &label) const = 0;
+
+    /*! \fn DotPreprocessor::decodeEdgeLabel()
+        \brief Decodes an edge label into its attributes
+        \note Runs on pool threads alongside other calls; it mustn't change any shared state
+     */
+    virtual Attributes decodeEdgeLabel(const QString &label) const = 0;
+
+    /*! \fn DotPreprocessor::storeNodeLabel()
+        \brief Keeps the decoded attributes of a node; called on the preprocessing thread, in file order
+        \returns Text that replaces the label in the output
+     */
+    virtual QString storeNodeLabel(const qint64 &id, const Attributes &attributes) = 0;
+
+    /*! \fn DotPreprocessor::storeEdgeLabel()
+        \brief Keeps the decoded attributes of an edge; called on the preprocessing thread, in file order
+        \param id ID of the edge's head node
+        \returns Text that replaces the label in the output
+     */
+    virtual QString storeEdgeLabel(const qint64 &id, const Attributes &attributes) = 0;
+
+    enum RecordType {
+        Record_None,
+        Record_Node,
+        Record_Edge
+    };
+
+    //! A labeled node or edge statement; each [begin, end) pair is a span of the content
+    struct Record {
+        RecordType type;
+        qint64 id;          //!< ID of the node, or of the edge's head node
+        qint64 tail;        //!< ID of the edge's tail node; 0 for nodes
+        int lineBegin;
+        int lineEnd;        //!< End of the line, before its newline
+        int idBegin;
+        int idEnd;
+        int tailBegin;
+        int tailEnd;
+        int labelBegin;
+        int labelEnd;
+    };
+
+    //! A run of records decoded together on one pool thread
+    struct DecodeChunk {
+        const DotPreprocessor *preprocessor;
+        const QChar *data;
+        const Record *records;
+        Attributes *attributes;
+        int count;
+    };
+
+    static QVector<Record> scan(const QString &content);
+    void decode(const QString &content, const QVector<Record> &records, QVector<Attributes> &attributes) const;
+    static void decodeChunk(DecodeChunk &chunk);
+
+    static bool parseRecord(const QChar *data, int begin, int end, Record *record);
+    static bool findLabel(const QChar *data, int begin, int end, int *labelBegin, int *labelEnd);
+
+    static int indexOf(const QChar *data, int begin, int end, const char *text);
+    static qint64 toId(const QChar *data, int begin, int end);
+
+private:
+    bool m_ConcurrentDecode;
+
+    friend class DotRewriter;
+};
+
+} // namespace DirectedGraph
+} // namespace Plugins
+
+#endif // PLUGINS_DIRECTEDGRAPH_DOTPREPROCESSOR_H
@@ -0,0 +1,311 @@
+/*!
+   \file DotRewriter.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "DotRewriter.h"
+
+#include "RankList.h"
+
+namespace Plugins {
+namespace DirectedGraph {
+
+/*! \class DotRewriter
+    \brief Rewrites STAT's DOT content on the statements found by the DotPreprocessor scanner
+
+    The rewriting functions only read their arguments, and may run on any thread.
+ */
+
+/*! \fn DotRewriter::selectRanks()
+    \brief Cuts the DOT content of a sample down to the call paths of some ranks
+    \param content GraphViz DOT content as rendered by STAT
+    \param ranks Ranks to keep; the content is returned as it is if this is empty
+    \returns Content with the process lists of the edges cut down to the given ranks, and without the frames that
+             none of them pass through
+
+    The ranks of a truncated process list aren't all known, so its edge is dropped along with the frames below it
+    that no other remaining edge leads to.
+ */
+QByteArray DotRewriter::selectRanks(const QByteArray &content, const QList<quint64> &ranks)
+{
+    if(ranks.isEmpty()) {
+        return content;
+    }
+
+    QSet<quint64> selected = ranks.toSet();
+
+    QString text = QString::fromUtf8(content);
+    QVector<Record> records = DotPreprocessor::scan(text);
+
+    // Cut the process list of every edge down to the selection
+    QHash<int, QString> labels;
+    QMultiHash<qint64, int> edgesByTail;
+    QSet<qint64> heads;
+
+    for(int i = 0; i < records.count(); ++i) {
+        const Record &record = records.at(i);
+        if(record.type != DotPreprocessor::Record_Edge) {
+            continue;
+        }
+
+        heads.insert(record.id);
+
+        QStringList processList = RankList::fromLabel(label(text, record));
+        if(processList.isEmpty() || RankList::isTruncated(processList)) {
+            continue;
+        }
+
+        QList<quint64> edgeRanks = RankList::select(processList, selected);
+        if(edgeRanks.isEmpty()) {
+            continue;
+        }
+
+        labels.insert(i, RankList::toLabel(edgeRanks));
+        edgesByTail.insert(record.tail, i);
+    }
+
+    // Keep the frames that can still be reached from a root through the remaining edges
+    QSet<qint64> reached;
+    QList<qint64> pending;
+
+    foreach(const Record &record, records) {
+        if(record.type == DotPreprocessor::Record_Node && !heads.contains(record.id)) {
+            reached.insert(record.id);
+            pending.append(record.id);
+        }
+    }
+
+    while(!pending.isEmpty()) {
+        foreach(int i, edgesByTail.values(pending.takeFirst())) {
+            qint64 head = records.at(i).id;
+            if(!reached.contains(head)) {
+                reached.insert(head);
+                pending.append(head);
+            }
+        }
+    }
+
+    // Copy the content, relabeling the remaining edges and leaving out the lines of everything else
+    QString retval;
+    retval.reserve(text.size());
+    int copied = 0;
+
+    for(int i = 0; i < records.count(); ++i) {
+        const Record &record = records.at(i);
+
+        bool keep;
+        if(record.type == DotPreprocessor::Record_Node) {
+            keep = reached.contains(record.id);
+        } else {
+            keep = labels.contains(i) && reached.contains(record.tail);
+        }
+
+        if(keep && record.type == DotPreprocessor::Record_Node) {
+            continue;
+        }
+
+        if(keep) {
+            retval.append(QStringRef(&text, copied, record.labelBegin - copied));
+            retval.append(labels.value(i));
+            copied = record.labelEnd;
+        } else {
+            retval.append(QStringRef(&text, copied, record.lineBegin - copied));
+            copied = qMin(record.lineEnd + 1, text.size());
+        }
+    }
+
+    retval.append(QStringRef(&text, copied, text.size() - copied));
+
+    return retval.toUtf8();
+}
+
+/*! \fn DotRewriter::refine()
+    \brief Replaces the call paths of some tasks in a coarse sample with their call paths from a detailed sample
+    \param coarse DOT content of the sample being refined, typically a function-only sample of every task
+    \param detailed DOT content of a later sample of the same job, typically with line numbers
+    \param tasks Tasks whose call paths are taken from the detailed sample
+    \returns DOT content with both sets of call paths hanging off the root of the coarse sample
+
+    Edges whose process list was truncated, or can't be read, can't be split by task; they are kept as they are from
+    the coarse sample, and dropped from the detailed one.
+ */
+QByteArray DotRewriter::refine(const QByteArray &coarse, const QByteArray &detailed, const QList<quint64> &tasks)
+{
+    QSet<quint64> refined = tasks.toSet();
+
+    QString header;
+    QString body;
+    QString footer;
+
+    qint64 nextId = 0;
+    qint64 rootId = 0;
+    bool rootFound = false;
+
+    for(int pass = 0; pass < 2; ++pass) {
+        bool isDetailed = (pass == 1);
+        QString text = QString::fromUtf8(isDetailed ? detailed : coarse);
+        QVector<Record> records = DotPreprocessor::scan(text);
+
+        // Split the process list of every edge into the refined tasks and the rest
+        QSet<qint64> heads;
+        QSet<qint64> keptHeads;
+        QHash<int, QString> labels;
+        QList<int> edges;
+
+        for(int i = 0; i < records.count(); ++i) {
+            const Record &record = records.at(i);
+            if(record.type != DotPreprocessor::Record_Edge) {
+                continue;
+            }
+
+            heads.insert(record.id);
+
+            QString edgeLabel = label(text, record);
+            QStringList processList = RankList::fromLabel(edgeLabel);
+
+            if(processList.isEmpty() || RankList::isTruncated(processList)) {
+                if(isDetailed) {
+                    continue;
+                }
+            } else {
+                QList<quint64> edgeTasks = RankList::select(processList, refined, isDetailed);
+                if(edgeTasks.isEmpty()) {
+                    continue;
+                }
+
+                edgeLabel = RankList::toLabel(edgeTasks);
+            }
+
+            keptHeads.insert(record.id);
+            labels.insert(i, edgeLabel);
+            edges.append(i);
+        }
+
+        // The detailed call paths start from the coarse root; every other node is given an unused ID
+        QList<qint64> nodeIds;
+        foreach(const Record &record, records) {
+            if(record.type == DotPreprocessor::Record_Node) {
+                nodeIds.append(record.id);
+            }
+        }
+        foreach(int i, edges) {
+            nodeIds << records.at(i).tail << records.at(i).id;
+        }
+
+        QHash<qint64, qint64> ids;
+        foreach(qint64 id, nodeIds) {
+            if(ids.contains(id)) {
+                continue;
+            }
+
+            if(!isDetailed) {
+                if(!heads.contains(id) && !rootFound) {
+                    rootId = id;
+                    rootFound = true;
+                }
+                ids.insert(id, id);
+                nextId = qMax(nextId, id + 1);
+            } else if(!heads.contains(id)) {
+                ids.insert(id, rootId);
+            } else {
+                ids.insert(id, nextId++);
+            }
+        }
+
+        foreach(const Record &record, records) {
+            if(record.type != DotPreprocessor::Record_Node) {
+                continue;
+            }
+
+            if(heads.contains(record.id) && !keptHeads.contains(record.id)) {
+                continue;
+            }
+
+            if(!heads.contains(record.id) && isDetailed) {
+                continue;   // Already there as the coarse root
+            }
+
+            body.append(line(text, record, ids, label(text, record)));
+        }
+
+        foreach(int i, edges) {
+            body.append(line(text, records.at(i), ids, labels.value(i)));
+        }
+
+        // Whatever isn't a node or edge statement is taken from the coarse sample
+        if(!isDetailed) {
+            int copied = records.isEmpty() ? text.size() : records.first().lineBegin;
+            header = text.left(copied);
+
+            foreach(const Record &record, records) {
+                footer.append(QStringRef(&text, copied, qMax(0, record.lineBegin - copied)));
+                copied = qMin(record.lineEnd + 1, text.size());
+            }
+
+            footer.append(QStringRef(&text, copied, text.size() - copied));
+        }
+    }
+
+    return (header + body + footer).toUtf8();
+}
+
+/*! \fn DotRewriter::label()
+    \returns Text of the record's label, without its quotes
+ */
+QString DotRewriter::label(const QString &content, const Record &record)
+{
+    return QString(content.constData() + record.labelBegin, record.labelEnd - record.labelBegin);
+}
+
+/*! \fn DotRewriter::line()
+    \returns Line of the record, with its IDs mapped through ids and its label replaced
+ */
+QString DotRewriter::line(const QString &content, const Record &record, const QHash<qint64, qint64> &ids,
+                          const QString &label)
+{
+    QString retval;
+    int copied = record.lineBegin;
+
+    if(record.type == DotPreprocessor::Record_Edge) {
+        retval.append(QStringRef(&content, copied, record.tailBegin - copied));
+        retval.append(QString::number(ids.value(record.tail)));
+        copied = record.tailEnd;
+    }
+
+    retval.append(QStringRef(&content, copied, record.idBegin - copied));
+    retval.append(QString::number(ids.value(record.id)));
+
+    retval.append(QStringRef(&content, record.idEnd, record.labelBegin - record.idEnd));
+    retval.append(label);
+
+    retval.append(QStringRef(&content, record.labelEnd, record.lineEnd - record.labelEnd));
+    retval.append(QLatin1Char('\n'));
+
+    return retval;
+}
+
+} // namespace DirectedGraph
+} // namespace Plugins
@@ -0,0 +1,57 @@
+/*!
+   \file DotRewriter.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef PLUGINS_DIRECTEDGRAPH_DOTREWRITER_H
+#define PLUGINS_DIRECTEDGRAPH_DOTREWRITER_H
+
+#include <QtCore>
+
+#include "../SWATLibrary.h"
+#include "DotPreprocessor.h"
+
+namespace Plugins {
+namespace DirectedGraph {
+
+class SWAT_EXPORT DotRewriter
+{
+public:
+    static QByteArray selectRanks(const QByteArray &content, const QList<quint64> &ranks);
+    static QByteArray refine(const QByteArray &coarse, const QByteArray &detailed, const QList<quint64> &tasks);
+
+protected:
+    typedef DotPreprocessor::Record Record;
+
+    static QString label(const QString &content, const Record &record);
+    static QString line(const QString &content, const Record &record, const QHash<qint64, qint64> &ids,
+                        const QString &label);
+};
+
+} // namespace DirectedGraph
+} // namespace Plugins
+
+#endif // PLUGINS_DIRECTEDGRAPH_DOTREWRITER_H
@@ -60,16 +60,24 @@ GraphLibAdapter::~GraphLibAdapter()
     graphIds.append(m_Nodes.keys());
     graphIds.append(m_Edges.keys());
     foreach(QUuid graphId, graphIds) {
-        if(m_Nodes.contains(graphId)) {
-            QList<GraphLibNode *> *nodes = m_Nodes.take(graphId);
-            qDeleteAll(*nodes);
-            delete nodes;
-        }
-        if(m_Edges.contains(graphId)) {
-            QList<GraphLibEdge *> *edges = m_Edges.take(graphId);
-            qDeleteAll(*edges);
-            delete edges;
-        }
+        deleteAttributes(graphId);
+    }
+}
+
+/*! \fn GraphLibAdapter::deleteAttributes()
+    \brief Frees the node and edge attribute caches of a graph
+ */
+void GraphLibAdapter::deleteAttributes(const QUuid &graphId)
+{
+    if(m_Nodes.contains(graphId)) {
+        QList<GraphLibNode *> *nodes = m_Nodes.take(graphId);
+        qDeleteAll(*nodes);
+        delete nodes;
+    }
+    if(m_Edges.contains(graphId)) {
+        QList<GraphLibEdge *> *edges = m_Edges.take(graphId);
+        qDeleteAll(*edges);
+        delete edges;
     }
 }
 
@@ -99,7 +107,10 @@ QUuid GraphLibAdapter::createGraph(const QString &filename)
 void GraphLibAdapter::deleteGraph(const QUuid &graphId)
 {
     graphlib_graph_p graph = this->graph(graphId);
+    m_Graphs.remove(graphId);
     graphlib_delGraph(graph);
+
+    deleteAttributes(graphId);
 }
 
 
@@ -185,6 +196,15 @@ void GraphLibAdapter::processAttributes(const QUuid &graphId)
 
 }
 
+/*! \fn GraphLibAdapter::isProcessed()
+    \returns True if the graph's node and edge fragments have been read by processAttributes(); they can't be without
+             GRAPHRENDERORDER
+ */
+bool GraphLibAdapter::isProcessed(const QUuid &graphId) const
+{
+    return m_Nodes.contains(graphId) && m_Edges.contains(graphId);
+}
+
 const QList<GraphLibNode *> &GraphLibAdapter::nodes(QUuid graphId) const
 {
     if(!m_Graphs.contains(graphId)) {
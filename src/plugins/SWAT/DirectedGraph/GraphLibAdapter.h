@@ -63,12 +63,14 @@ public:
     QByteArray exportDotContent(const QUuid &graphId);
 
     void processAttributes(const QUuid &graphId);
+    bool isProcessed(const QUuid &graphId) const;
     const QList<GraphLibNode *> &nodes(QUuid graphId) const;
     const QList<GraphLibEdge *> &edges(QUuid graphId) const;
 
 protected:
     GraphLibAdapter();
     graphlib_graph_p graph(const QUuid &graphId) const;
+    void deleteAttributes(const QUuid &graphId);
 
 private:
     QMap<QUuid, graphlib_graph_p> m_Graphs;
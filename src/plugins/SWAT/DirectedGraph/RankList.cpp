@@ -0,0 +1,225 @@
+/*!
+   \file RankList.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "RankList.h"
+
+namespace Plugins {
+namespace DirectedGraph {
+
+/*! \class RankList
+    \brief Reads and writes STAT process lists, such as "0-3,7,..."
+
+    A process list is a list of ranks and inclusive rank ranges.  STAT truncates long lists on the edges it
+    renders, ending them with an ellipsis; the ranks of a truncated list aren't all known.
+ */
+
+/*! \fn RankList::fromLabel()
+    \brief Reads the process list of a STAT edge label, "count:[list]"
+    \param count Set to the count given before the list, or to an empty string if there is none
+    \returns Process list, or an empty list if the label doesn't hold one
+ */
+QStringList RankList::fromLabel(const QString &label, QString *count)
+{
+    if(count) {
+        count->clear();
+    }
+
+    int open = label.indexOf('[');
+    int close = label.lastIndexOf(']');
+    if(open < 0 || close < open) {
+        return QStringList();
+    }
+
+    QString prefix = label.left(open);
+    if(prefix.endsWith(':')) {
+        prefix.chop(1);
+    }
+
+    // An empty list is read from the count, as STAT's own label parsing does
+    QString list = label.mid(open + 1, close - open - 1);
+    if(list.isEmpty()) {
+        return prefix.split(',');
+    }
+
+    if(count) {
+        *count = prefix;
+    }
+
+    return list.split(',');
+}
+
+/*! \fn RankList::toLabel()
+    \returns STAT edge label for the ranks, "count:[list]"
+ */
+QString RankList::toLabel(const QList<quint64> &ranks)
+{
+    return QString("%1:[%2]").arg(ranks.count()).arg(merge(ranks).join(","));
+}
+
+/*! \fn RankList::isTruncated()
+    \returns True if STAT left ranks out of the list
+ */
+bool RankList::isTruncated(const QStringList &processList)
+{
+    return processList.contains("...");
+}
+
+/*! \fn RankList::count()
+    \returns Number of ranks in the list; entries that can't be read count as one rank
+ */
+quint64 RankList::count(const QStringList &processList)
+{
+    quint64 retval = 0;
+
+    foreach(QString processes, processList) {
+        quint64 first, last;
+        if(parseRange(processes, &first, &last) && first <= last) {
+            retval += (last - first) + 1;
+        } else {
+            ++retval;
+        }
+    }
+
+    return retval;
+}
+
+/*! \fn RankList::split()
+    \returns Every rank in the list; entries that can't be read, such as an ellipsis, are skipped
+ */
+QList<quint64> RankList::split(const QStringList &processList)
+{
+    QList<quint64> retval;
+
+    foreach(QString processes, processList) {
+        quint64 first, last;
+        if(!parseRange(processes, &first, &last)) {
+            continue;
+        }
+
+        for(quint64 rank = first; rank <= last; ++rank) {
+            retval << rank;
+            if(rank == last) {
+                break;  // Don't wrap around at the largest rank
+            }
+        }
+    }
+
+    return retval;
+}
+
+/*! \fn RankList::merge()
+    \returns Process list of the ranks, sorted, with consecutive ranks merged into ranges
+ */
+QStringList RankList::merge(const QList<quint64> &ranks)
+{
+    QList<quint64> sorted = ranks;
+    qSort(sorted);
+
+    QStringList retval;
+    for(int first = 0; first < sorted.count(); ) {
+        int last = first;
+        while(last + 1 < sorted.count() && sorted.at(last + 1) <= sorted.at(last) + 1) {
+            ++last;
+        }
+
+        if(sorted.at(first) == sorted.at(last)) {
+            retval << QString::number(sorted.at(first));
+        } else {
+            retval << QString("%1-%2").arg(sorted.at(first)).arg(sorted.at(last));
+        }
+
+        first = last + 1;
+    }
+
+    return retval;
+}
+
+/*! \fn RankList::select()
+    \param inside True to return the ranks of the list that are in the set, false for those that aren't
+    \returns Ranks of the list, in list order
+ */
+QList<quint64> RankList::select(const QStringList &processList, const QSet<quint64> &ranks, bool inside)
+{
+    QList<quint64> retval;
+
+    foreach(QString processes, processList) {
+        quint64 first, last;
+        if(!parseRange(processes, &first, &last)) {
+            continue;
+        }
+
+        // Walk whichever is shorter, the range or the set
+        if(inside && last - first >= (quint64)ranks.count()) {
+            QList<quint64> found;
+            foreach(quint64 rank, ranks) {
+                if(rank >= first && rank <= last) {
+                    found.append(rank);
+                }
+            }
+            qSort(found);
+            retval << found;
+            continue;
+        }
+
+        for(quint64 rank = first; rank <= last; ++rank) {
+            if(ranks.contains(rank) == inside) {
+                retval << rank;
+            }
+            if(rank == last) {
+                break;
+            }
+        }
+    }
+
+    return retval;
+}
+
+/*! \fn RankList::parseRange()
+    \brief Reads a single rank, "n", or an inclusive range, "first-last"
+ */
+bool RankList::parseRange(const QString &processes, quint64 *first, quint64 *last)
+{
+    bool okay;
+
+    int dash = processes.indexOf('-');
+    if(dash < 0) {
+        *first = *last = processes.trimmed().toULongLong(&okay);
+        return okay;
+    }
+
+    *first = processes.left(dash).trimmed().toULongLong(&okay);
+    if(!okay) {
+        return false;
+    }
+
+    *last = processes.mid(dash + 1).trimmed().toULongLong(&okay);
+    return okay && *first <= *last;
+}
+
+} // namespace DirectedGraph
+} // namespace Plugins
@@ -0,0 +1,59 @@
+/*!
+   \file RankList.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef PLUGINS_DIRECTEDGRAPH_RANKLIST_H
+#define PLUGINS_DIRECTEDGRAPH_RANKLIST_H
+
+#include <QtCore>
+
+#include "../SWATLibrary.h"
+
+namespace Plugins {
+namespace DirectedGraph {
+
+class SWAT_EXPORT RankList
+{
+public:
+    static QStringList fromLabel(const QString &label, QString *count = NULL);
+    static QString toLabel(const QList<quint64> &ranks);
+
+    static bool isTruncated(const QStringList &processList);
+    static quint64 count(const QStringList &processList);
+
+    static QList<quint64> split(const QStringList &processList);
+    static QStringList merge(const QList<quint64> &ranks);
+    static QList<quint64> select(const QStringList &processList, const QSet<quint64> &ranks, bool inside = true);
+
+protected:
+    static bool parseRange(const QString &processes, quint64 *first, quint64 *last);
+};
+
+} // namespace DirectedGraph
+} // namespace Plugins
+
+#endif // PLUGINS_DIRECTEDGRAPH_RANKLIST_H
@@ -29,6 +29,7 @@
 
 #include "STATScene.h"
 #include "STATEdge.h"
+#include "RankList.h"
 
 #include <QDebug>
 
@@ -43,31 +44,31 @@ STATNode::STATNode(node_t *node, STATScene *scene, QGraphicsItem *parent) :
 
 QString STATNode::functionName()
 {
-    QString retval = m_Scene->nodeInfo(nodeId(), STATScene::NodeInfoType_FunctionName).toString();
+    QString retval = m_Scene->nodeAttributes().string(nodeId(), STATScene::NodeInfoType_FunctionName);
     return retval;
 }
 
 quint64 STATNode::programCounter()
 {
-    quint64 retval = m_Scene->nodeInfo(nodeId(), STATScene::NodeInfoType_ProgramCounter).toULongLong();
+    quint64 retval = m_Scene->nodeAttributes().integer(nodeId(), STATScene::NodeInfoType_ProgramCounter);
     return retval;
 }
 
 QString STATNode::sourceFile()
 {
-    QString retval = m_Scene->nodeInfo(nodeId(), STATScene::NodeInfoType_SourceFile).toString();
+    QString retval = m_Scene->nodeAttributes().string(nodeId(), STATScene::NodeInfoType_SourceFile);
     return retval;
 }
 
 quint32 STATNode::sourceLine()
 {
-    quint32 retval = m_Scene->nodeInfo(nodeId(), STATScene::NodeInfoType_SourceLine).toUInt();
+    quint32 retval = (quint32)m_Scene->nodeAttributes().integer(nodeId(), STATScene::NodeInfoType_SourceLine);
     return retval;
 }
 
 QString STATNode::iter()
 {
-    QString retval = m_Scene->nodeInfo(nodeId(), STATScene::NodeInfoType_IterString).toString();
+    QString retval = m_Scene->nodeAttributes().string(nodeId(), STATScene::NodeInfoType_IterString);
     return retval;
 }
 
@@ -75,13 +76,13 @@ QString STATNode::iter()
 
 QString STATNode::processCount()
 {
-    QString retval = m_Scene->edgeInfo(nodeId(), STATScene::EdgeInfoType_ProcessCount).toString();
+    QString retval = m_Scene->edgeAttributes().string(nodeId(), STATScene::EdgeInfoType_ProcessCount);
     return retval;
 }
 
 QStringList STATNode::processList()
 {
-    QStringList retval =  m_Scene->edgeInfo(nodeId(), STATScene::EdgeInfoType_ProcessList).toStringList();
+    QStringList retval = m_Scene->edgeAttributes().rankList(nodeId(), STATScene::EdgeInfoType_ProcessList);
     return retval;
 }
 
@@ -89,85 +90,17 @@ QStringList STATNode::processList()
 
 QList<quint64> STATNode::splitProcessList(const QStringList &lists)
 {
-    QList<quint64> retval;
-
-    foreach(QString list, lists) {
-        retval << splitProcessList(list);
-    }
-
-    return retval;
+    return RankList::split(lists);
 }
 
 QList<quint64> STATNode::splitProcessList(const QString &list)
 {
-    static const QRegExp rxRange("^([0-9]+)\\-([0-9]+)$");
-
-    bool okay;
-    QList<quint64> retval;
-
-    if(rxRange.indexIn(list) >= 0) {
-        quint64 start = rxRange.cap(1).toLongLong(&okay);
-        if(!okay) {
-            qWarning() << "Failed to parse process list properly (start)";
-            return retval;
-        }
-
-        quint64 finish = rxRange.cap(2).toLongLong(&okay);
-        if(!okay) {
-            qWarning() << "Failed to parse process list properly (finish)";
-            return retval;
-        }
-
-        for(quint64 i = start; i <= finish; ++i) {
-            retval << i;
-        }
-
-    } else {
-        quint64 value = list.toLongLong(&okay);
-        if(!okay) {
-            qWarning() << "Failed to parse process list properly (single)";
-            return retval;
-        }
-
-        retval << value;
-    }
-
-    return retval;
-
+    return RankList::split(QStringList(list));
 }
 
 QStringList STATNode::mergeProcessList(const QList<quint64> &list)
 {
-    QStringList retval;
-
-    QList<quint64>sortedList = list;
-    qSort(sortedList.begin(), sortedList.end());
-
-    static const quint64 max64 = -1;
-    quint64 start = max64;
-    quint64 end = max64;
-    quint64 last = max64;
-    for(int i = 0; i <= sortedList.count(); ++i) {
-        quint64 value = max64;
-        if(i < sortedList.count()) {
-            value = sortedList.at(i);
-        }
-
-        if(last != max64 && value == (last + 1)) {
-            end = last = value;
-        } else {
-            if(start != max64) {
-                if(start == end) {
-                    retval << QString::number(start);
-                } else {
-                    retval << QString("%1-%2").arg(start).arg(end);
-                }
-            }
-            end = start = last = value;
-        }
-    }
-
-    return retval;
+    return RankList::merge(list);
 }
 
 
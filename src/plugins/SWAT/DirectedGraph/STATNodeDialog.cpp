@@ -28,6 +28,8 @@
 #include "STATNodeDialog.h"
 #include "ui_STATNodeDialog.h"
 
+#include <QMenu>
+
 #include "STATWidget.h"
 #include "STATNode.h"
 
@@ -43,6 +45,16 @@ STATNodeDialog::STATNodeDialog(QWidget *parent) :
     ui->grpLeafTasks->setVisible(false);
     ui->grpTotalTasks->setVisible(false);
 
+    QMenu *sampleTasksMenu = new QMenu(this);
+    sampleTasksMenu->addAction(tr("Total Tasks"), this, SLOT(sampleTotalTasks()));
+    m_SampleLeafTasks = sampleTasksMenu->addAction(tr("Leaf Tasks"), this, SLOT(sampleLeafTasks()));
+    ui->btnSampleTasks->setMenu(sampleTasksMenu);
+
+    QMenu *detachMenu = new QMenu(this);
+    detachMenu->addAction(tr("Keep Total Tasks Stopped"), this, SLOT(detachTotalTasksStopped()));
+    m_DetachLeafTasksStopped = detachMenu->addAction(tr("Keep Leaf Tasks Stopped"), this, SLOT(detachLeafTasksStopped()));
+    ui->btnDetach->setMenu(detachMenu);
+
     connect(this, SIGNAL(finished(int)), this, SLOT(onFinished()));
 }
 
@@ -83,6 +95,14 @@ void STATNodeDialog::setNode(STATNode *node)
 
     ui->btnViewSource->setEnabled(!m_Node->sourceFile().isEmpty());
 
+    // A truncated process list can't tell which tasks to refine, sample or keep stopped
+    bool tasksKnown = !m_Node->processList().isEmpty() && !m_Node->processList().contains("...");
+    ui->btnRefine->setEnabled(tasksKnown);
+    ui->btnSampleTasks->setEnabled(tasksKnown);
+    ui->btnDetach->setEnabled(tasksKnown);
+    m_SampleLeafTasks->setEnabled(tasksKnown && !m_Node->leafTasks().isEmpty());
+    m_DetachLeafTasksStopped->setEnabled(tasksKnown && !m_Node->leafTasks().isEmpty());
+
     // Leaf Tasks
     QStringList leafTasks = m_Node->leafTasks();
     if(!leafTasks.isEmpty()) {
@@ -170,5 +190,70 @@ void STATNodeDialog::on_btnViewSource_clicked()
     }
 }
 
+void STATNodeDialog::on_btnRefine_clicked()
+{
+    if(!m_Node) {
+        return;
+    }
+
+    if(STATWidget *view = qobject_cast<STATWidget *>(parent())) {
+        view->doRefine(m_Node);
+    }
+
+    accept();
+}
+
+void STATNodeDialog::sampleTotalTasks()
+{
+    if(!m_Node) {
+        return;
+    }
+
+    if(STATWidget *view = qobject_cast<STATWidget *>(parent())) {
+        view->doSampleTasks(m_Node->processList());
+    }
+
+    accept();
+}
+
+void STATNodeDialog::sampleLeafTasks()
+{
+    if(!m_Node) {
+        return;
+    }
+
+    if(STATWidget *view = qobject_cast<STATWidget *>(parent())) {
+        view->doSampleTasks(m_Node->leafTasks());
+    }
+
+    accept();
+}
+
+void STATNodeDialog::detachTotalTasksStopped()
+{
+    if(!m_Node) {
+        return;
+    }
+
+    if(STATWidget *view = qobject_cast<STATWidget *>(parent())) {
+        view->doDetachTasksStopped(m_Node->processList());
+    }
+
+    accept();
+}
+
+void STATNodeDialog::detachLeafTasksStopped()
+{
+    if(!m_Node) {
+        return;
+    }
+
+    if(STATWidget *view = qobject_cast<STATWidget *>(parent())) {
+        view->doDetachTasksStopped(m_Node->leafTasks());
+    }
+
+    accept();
+}
+
 } // namespace DirectedGraph
 } // namespace Plugins
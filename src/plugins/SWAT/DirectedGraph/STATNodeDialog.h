@@ -60,6 +60,11 @@ protected slots:
     void on_btnCollapseDepth_clicked();
     void on_btnFocus_clicked();
     void on_btnViewSource_clicked();
+    void on_btnRefine_clicked();
+    void sampleTotalTasks();
+    void sampleLeafTasks();
+    void detachTotalTasksStopped();
+    void detachLeafTasksStopped();
 
     void onFinished();
 
@@ -67,6 +72,8 @@ protected slots:
 private:
     Ui::STATNodeDialog *ui;
     STATNode *m_Node;
+    QAction *m_SampleLeafTasks;
+    QAction *m_DetachLeafTasksStopped;
 
 };
 
@@ -29,6 +29,7 @@
 
 #include "STATEdge.h"
 #include "STATNode.h"
+#include "RankList.h"
 
 namespace Plugins {
 namespace DirectedGraph {
@@ -36,6 +37,14 @@ namespace DirectedGraph {
 STATScene::STATScene(QObject *parent) :
     DirectedGraphScene(parent)
 {
+    defineNodeInfo(NodeInfoType_FunctionName, AttributeStore::Column_String);
+    defineNodeInfo(NodeInfoType_ProgramCounter, AttributeStore::Column_Integer);
+    defineNodeInfo(NodeInfoType_SourceFile, AttributeStore::Column_String);
+    defineNodeInfo(NodeInfoType_SourceLine, AttributeStore::Column_Integer);
+    defineNodeInfo(NodeInfoType_IterString, AttributeStore::Column_String);
+
+    defineEdgeInfo(EdgeInfoType_ProcessCount, AttributeStore::Column_Text);
+    defineEdgeInfo(EdgeInfoType_ProcessList, AttributeStore::Column_RankSet);
 }
 
 QGraphVizNode *STATScene::createNode(node_t *node)
@@ -48,34 +57,85 @@ QGraphVizEdge *STATScene::createEdge(edge_t *edge)
     return new STATEdge(edge, this);
 }
 
+// Characters of a frame's function name, and of its source file; the same classes the STAT labels use
+static inline bool isNameChar(const QChar &c)
+{
+    return c.isLetterOrNumber() || c.isMark() || c == '_' || c == '-' || c == '.';
+}
+
+static inline bool isPathChar(const QChar &c)
+{
+    return isNameChar(c) || c == '/' || c == '\\';
+}
 
-void STATScene::processNodeLabel(const qint64 &id, const QString &label)
+/*! \fn STATScene::decodeNodeLabel()
+    \brief Splits a STAT frame label (function\@file:line$iterations, or function\@pc) into the node's information
+    \note Called from pool threads while loading
+ */
+DirectedGraphScene::Attributes STATScene::decodeNodeLabel(const QString &label) const
 {
     static const quint8 maxNodeLabelSize = 64;
-    static QRegExp rxFullText = QRegExp("^([\\d\\w\\_\\-\\.]+)(?:@([\\d\\w\\_\\-\\.\\/\\\\]+)(?:\\:(\\d+))?)?(?:\\$(.+))?");
 
+    Attributes attributes;
+
+    // Scanned by hand; QRegExp takes a global lock on construction and matching, and this runs on every thread
     QString longLabel = label.trimmed();
-    if(rxFullText.indexIn(longLabel) >= 0) {
-        setNodeInfo(id, NodeInfoType_FunctionName, rxFullText.cap(1));
-        longLabel = rxFullText.cap(1);
-
-        if(!rxFullText.cap(2).isEmpty()) {
-            if(!rxFullText.cap(3).isEmpty()) {
-                QString sourceFile = rxFullText.cap(2);
-                quint32 sourceLine = rxFullText.cap(3).toULong();
-                setNodeInfo(id, NodeInfoType_SourceFile, sourceFile);
-                setNodeInfo(id, NodeInfoType_SourceLine, sourceLine);
-                longLabel += QString("@%1:%2").arg(QFileInfo(sourceFile).fileName()).arg(sourceLine);
+    const QChar *text = longLabel.constData();
+    const int length = longLabel.length();
+
+    int nameEnd = 0;
+    while(nameEnd < length && isNameChar(text[nameEnd])) ++nameEnd;
+
+    if(nameEnd > 0) {
+        QString functionName = longLabel.left(nameEnd);
+        int position = nameEnd;
+
+        // @file:line, or @pc
+        int fileEnd = position + 1;
+        if(position < length && text[position] == '@') {
+            while(fileEnd < length && isPathChar(text[fileEnd])) ++fileEnd;
+        }
+
+        QString location;
+        QString sourceLine;
+        if(fileEnd > position + 1) {
+            location = longLabel.mid(position + 1, fileEnd - position - 1);
+            position = fileEnd;
+
+            int lineEnd = position + 1;
+            if(position < length && text[position] == ':') {
+                while(lineEnd < length && text[lineEnd].isDigit()) ++lineEnd;
+            }
+            if(lineEnd > position + 1) {
+                sourceLine = longLabel.mid(position + 1, lineEnd - position - 1);
+                position = lineEnd;
+            }
+        }
+
+        // $iterations runs to the end of the label
+        QString iterString;
+        if(position + 1 < length && text[position] == '$') {
+            iterString = longLabel.mid(position + 1);
+        }
+
+        attributes.insert(NodeInfoType_FunctionName, functionName);
+        longLabel = functionName;
+
+        if(!location.isEmpty()) {
+            if(!sourceLine.isEmpty()) {
+                quint32 line = sourceLine.toULong();
+                attributes.insert(NodeInfoType_SourceFile, location);
+                attributes.insert(NodeInfoType_SourceLine, line);
+                longLabel += QString("@%1:%2").arg(QFileInfo(location).fileName()).arg(line);
             } else {
-                quint64 programCounter = rxFullText.cap(2).toULongLong(0, 16);
-                setNodeInfo(id, NodeInfoType_ProgramCounter, programCounter);
+                quint64 programCounter = location.toULongLong(0, 16);
+                attributes.insert(NodeInfoType_ProgramCounter, programCounter);
                 longLabel += QString("@%1").arg(programCounter);
             }
         }
 
-        if(!rxFullText.cap(4).isEmpty()) {
-            QString iterString = rxFullText.cap(4);
-            setNodeInfo(id, NodeInfoType_IterString, iterString);
+        if(!iterString.isEmpty()) {
+            attributes.insert(NodeInfoType_IterString, iterString);
             longLabel += QString("$%1").arg(iterString);
         }
     }
@@ -86,55 +146,35 @@ void STATScene::processNodeLabel(const qint64 &id, const QString &label)
         shortLabel = "..." + shortLabel.right(maxNodeLabelSize - 3);
     }
 
-    setNodeInfo(id, NodeInfoType_LongLabel, longLabel);
-    setNodeInfo(id, NodeInfoType_ShortLabel, shortLabel);
+    attributes.insert(NodeInfoType_LongLabel, longLabel);
+    attributes.insert(NodeInfoType_ShortLabel, shortLabel);
+
+    return attributes;
 }
 
-void STATScene::processEdgeLabel(const qint64 &id, const QString &label)
+/*! \fn STATScene::decodeEdgeLabel()
+    \brief Reads the process list of a STAT edge label (count:[ranges]), and counts it if the count is missing
+    \note Called from pool threads while loading
+ */
+DirectedGraphScene::Attributes STATScene::decodeEdgeLabel(const QString &label) const
 {
     static const quint8 maxEdgeLabelSize = 24;
-    static QRegExp rxLabel = QRegExp("(?:(\\d+):)*\\[(.*)\\]");
-    static QRegExp rxRange = QRegExp("(\\d+)\\-(\\d+)");
 
-    QStringList processList;
+    Attributes attributes;
+
     QString processCount;
-    if(rxLabel.indexIn(label) >= 0) {
-        if(rxLabel.cap(2).isEmpty()) {
-            processList = rxLabel.cap(1).split(',');
-        } else {
-            processCount = rxLabel.cap(1);
-            processList = rxLabel.cap(2).split(',');
-        }
-    }
+    QStringList processList = RankList::fromLabel(label, &processCount);
 
     if(processCount.isEmpty()) {
-        if(processList.contains("...")) {
+        if(RankList::isTruncated(processList)) {
             processCount = "?";    // Can't count a truncated proc list
         } else {
-            bool okay;
-            quint64 numProcessCount = 0;
-
-            // Iterate through the list and count the procs
-            foreach(QString processes, processList) {
-                if(rxRange.indexIn(processes) >= 0 && rxRange.captureCount() == 2) {
-                    quint64 first = rxRange.cap(1).toULongLong(&okay);
-                    if(!okay) { continue; }
-
-                    quint64 last = rxRange.cap(2).toULongLong(&okay);
-                    if(!okay) { continue; }
-
-                    numProcessCount += (last - first) + 1;
-                } else {
-                    ++numProcessCount;
-                }
-            }
-
-            processCount = QString::number(numProcessCount);
+            processCount = QString::number(RankList::count(processList));
         }
     }
 
-    setEdgeInfo(id, EdgeInfoType_ProcessList, processList);
-    setEdgeInfo(id, EdgeInfoType_ProcessCount, processCount);
+    attributes.insert(EdgeInfoType_ProcessList, processList);
+    attributes.insert(EdgeInfoType_ProcessCount, processCount);
 
 
     QString longLabel = QString("%1:[%2]").arg(processCount).arg(processList.join(","));
@@ -151,11 +191,14 @@ void STATScene::processEdgeLabel(const qint64 &id, const QString &label)
     }
     QString shortLabel = QString("%1:[%2]").arg(processCount).arg(processList.join(","));
 
-    setEdgeInfo(id, EdgeInfoType_LongLabel, longLabel);
-    setEdgeInfo(id, EdgeInfoType_ShortLabel, shortLabel);
+    attributes.insert(EdgeInfoType_LongLabel, longLabel);
+    attributes.insert(EdgeInfoType_ShortLabel, shortLabel);
+
+    return attributes;
 }
 
 
 
+
 } // namespace DirectedGraph
 } // namespace Plugins
@@ -56,8 +56,8 @@ protected:
         EdgeInfoType_ProcessList = 3
     };
 
-    virtual void processNodeLabel(const qint64 &id, const QString &label);
-    virtual void processEdgeLabel(const qint64 &id, const QString &label);
+    virtual Attributes decodeNodeLabel(const QString &label) const;
+    virtual Attributes decodeEdgeLabel(const QString &label) const;
 
     virtual QGraphVizNode *createNode(node_t *node);
     virtual QGraphVizEdge *createEdge(edge_t *edge);
@@ -28,6 +28,7 @@
 #include "STATWidget.h"
 
 #include <MainWindow/MainWindow.h>
+#include <MainWindow/NotificationWidget.h>
 #include <SettingManager/SettingManager.h>
 #include <PluginManager/PluginManager.h>
 #include <SourceView/ISourceViewFactory.h>
@@ -35,6 +36,8 @@
 
 #include "STATScene.h"
 #include "STATNode.h"
+#include "RankList.h"
+#include "DotRewriter.h"
 #include "STATNodeDialog.h"
 
 
@@ -48,6 +51,8 @@ STATWidget::STATWidget(QWidget *parent) :
     m_HideNonBranching(NULL),
     m_EditToolBar(NULL)
 {
+    connect(&m_RefineWatcher, SIGNAL(finished()), this, SLOT(refineFinished()));
+
     using namespace Core::MainWindow;
     MainWindow &mainWindow = MainWindow::instance();
     foreach(QAction *action, mainWindow.menuBar()->actions()) {
@@ -99,6 +104,8 @@ void STATWidget::setContent(const QByteArray &content)
 {
     DirectedGraphWidget::setContent(content);
 
+    m_Content = content;
+
     connect(scene(), SIGNAL(selectionChanged()), this, SLOT(selectionChanged()));
 
     // Get settings from SettingManager and perform default functions on loaded scene
@@ -115,6 +122,170 @@ void STATWidget::setContent(const QByteArray &content)
     undoStack()->clear();  // Clear the undo stack so that the user is forced to use "expand all" to get to default
 }
 
+/*! \fn STATWidget::mergeContent()
+    \brief Updates the view with a newer sample of the same job, in place of opening another view
+    \param content GraphViz DOT content of the newer sample
+    \returns Number of stack frames that are new, or whose process list changed
+
+    A sample identical to the one shown is dropped without touching the scene, which is the usual case while a
+    hang is being watched.  Otherwise the newer sample is laid out and shown in the same view, keeping the zoom,
+    the position and the collapsed frames, and the frames that changed are highlighted.  Frames are matched by
+    their call path, because node IDs aren't stable between samples.
+ */
+int STATWidget::mergeContent(const QByteArray &content)
+{
+    if(!m_STATScene) {
+        setContent(content);
+        return 0;
+    }
+
+    if(content == m_Content) {
+        return 0;
+    }
+
+    QHash<QString, QString> edgeLabels;
+    QSet<QString> collapsedPaths;
+    foreach(QGraphVizNode *gvNode, m_STATScene->getNodes()) {
+        if(STATNode *node = qgraphicsitem_cast<STATNode *>(gvNode)) {
+            QString path = callPath(node);
+            edgeLabels.insert(path, node->edgeLabel());
+            if(node->isCollapsed()) {
+                collapsedPaths.insert(path);
+            }
+        }
+    }
+
+    STATScene *scene = new STATScene();
+    scene->setContent(QString(content));
+
+    int changed = 0;
+    QSet<STATNode *> newNodes;
+    foreach(QGraphVizNode *gvNode, scene->getNodes()) {
+        if(STATNode *node = qgraphicsitem_cast<STATNode *>(gvNode)) {
+            QString path = callPath(node);
+
+            QHash<QString, QString>::const_iterator previous = edgeLabels.constFind(path);
+            if(previous == edgeLabels.constEnd()) {
+                newNodes.insert(node);
+            }
+
+            if(previous == edgeLabels.constEnd() || previous.value() != node->edgeLabel()) {
+                node->setHighlighted(true);
+                ++changed;
+            }
+
+            if(collapsedPaths.contains(path)) {
+                node->setCollapsed(true);
+            }
+        }
+    }
+
+    // Frames that are new in this sample get the default hiding that setContent() gives a fresh view
+    if(!newNodes.isEmpty() && !scene->getNodes().isEmpty()) {
+        STATNode *root = qgraphicsitem_cast<STATNode *>(scene->getNodes().at(0));
+
+        Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+        settingManager.beginGroup("Plugins/SWAT");
+        bool hideMPI = settingManager.value("viewDefaults/hideMPI", true).toBool();
+        bool hideNonBranching = settingManager.value("viewDefaults/hideNonBranching", true).toBool();
+        settingManager.endGroup();
+
+        if(hideMPI) {
+            foreach(STATNode *node, HideMPICommand::mpiNodes(root)) {
+                if(newNodes.contains(node)) {
+                    node->setCollapsed(true);
+                }
+            }
+        }
+
+        if(hideNonBranching) {
+            foreach(STATNode *node, HideNonBranchingCommand::nonBranchingNodes(root)) {
+                if(newNodes.contains(node)) {
+                    node->setCollapsed(true);
+                }
+            }
+        }
+    }
+
+    STATScene *previousScene = m_STATScene;
+    m_STATScene = scene;
+    replaceScene(scene);
+    previousScene->deleteLater();
+
+    connect(scene, SIGNAL(selectionChanged()), this, SLOT(selectionChanged()));
+
+    m_Content = content;
+
+    return changed;
+}
+
+/*! \fn STATWidget::refineContent()
+    \brief Shows the call paths of some tasks from a more detailed sample, in place of their coarse call paths
+    \param detailed GraphViz DOT content of the detailed sample, typically with line numbers
+    \param processList Tasks to refine, as ranges like those of STATNode::processList()
+
+    The content is rewritten on a pool thread, and merged into the view when it's done; refined() is emitted then.
+    Refinements are applied one at a time, in the order they were asked for.
+ */
+void STATWidget::refineContent(const QByteArray &detailed, const QStringList &processList)
+{
+    m_RefineQueue.append(qMakePair(detailed, processList));
+
+    if(!m_RefineWatcher.isRunning()) {
+        startRefine();
+    }
+}
+
+/*! \fn STATWidget::startRefine()
+    \brief Starts rewriting the next queued refinement against the current content
+ */
+void STATWidget::startRefine()
+{
+    if(m_RefineQueue.isEmpty()) {
+        return;
+    }
+
+    QPair<QByteArray, QStringList> refinement = m_RefineQueue.takeFirst();
+    m_RefineTasks = refinement.second;
+
+    QList<quint64> tasks = RankList::split(m_RefineTasks);
+    m_RefineWatcher.setFuture(QtConcurrent::run(&DotRewriter::refine, m_Content, refinement.first, tasks));
+}
+
+/*! \fn STATWidget::refineFinished()
+    \brief Merges the rewritten content into the view, and moves on to the next queued refinement
+ */
+void STATWidget::refineFinished()
+{
+    QStringList processList = m_RefineTasks;
+    m_RefineTasks.clear();
+
+    try {
+        int changed = mergeContent(m_RefineWatcher.result());
+        emit refined(changed, processList);
+    } catch(QString err) {
+        using namespace Core::MainWindow;
+        MainWindow::instance().notify(tr("Failed to refine tasks: %1").arg(err), NotificationWidget::Critical);
+    } catch(...) {
+        using namespace Core::MainWindow;
+        MainWindow::instance().notify(tr("Failed to refine tasks."), NotificationWidget::Critical);
+    }
+
+    startRefine();
+}
+
+/*! \fn STATWidget::callPath()
+    \brief Identifies a stack frame by the labels of the frames leading to it from the root
+ */
+QString STATWidget::callPath(STATNode *node)
+{
+    QStringList frames;
+    for(DirectedGraphNode *frame = node; frame; frame = frame->parentNode()) {
+        frames.prepend(frame->label());
+    }
+    return frames.join("\n");
+}
+
 
 void STATWidget::doHideMPI()
 {
@@ -131,6 +302,21 @@ void STATWidget::doFocus(STATNode *node)
     undoStack()->push(new FocusNodeCommand(this, node));
 }
 
+void STATWidget::doRefine(STATNode *node)
+{
+    emit refineRequested(node->processList());
+}
+
+void STATWidget::doSampleTasks(const QStringList &processList)
+{
+    emit sampleTasksRequested(processList);
+}
+
+void STATWidget::doDetachTasksStopped(const QStringList &processList)
+{
+    emit detachRequested(processList);
+}
+
 void STATWidget::selectionChanged()
 {
     if(scene()->selectedItems().count() == 1) {
@@ -423,7 +609,7 @@ void HideMPICommand::redo()
     UndoCommand::redo();
 
     if(m_Nodes.isEmpty()) {
-        findNodes();
+        m_Nodes = mpiNodes(qgraphicsitem_cast<STATNode *>(view()->rootNode()));
     }
 
     foreach(STATNode *node, m_Nodes) {
@@ -433,14 +619,20 @@ void HideMPICommand::redo()
     setFailed(m_Nodes.isEmpty());
 }
 
-void HideMPICommand::findNodes(STATNode *parent)
+/*! \fn HideMPICommand::mpiNodes()
+    \returns Outermost MPI frames below the root that aren't already hidden
+ */
+QList<STATNode *> HideMPICommand::mpiNodes(STATNode *root)
 {
-    if(!parent) {
-        if(!(parent = qgraphicsitem_cast<STATNode *>(view()->rootNode()))) {
-            return;
-        }
+    QList<STATNode *> nodes;
+    if(root) {
+        findNodes(root, nodes);
     }
+    return nodes;
+}
 
+void HideMPICommand::findNodes(STATNode *parent, QList<STATNode *> &nodes)
+{
     if(parent->isCollapsed()) {
         return;
     }
@@ -452,12 +644,12 @@ void HideMPICommand::findNodes(STATNode *parent)
     }
 
     if(mpiFunctions().contains(label)) {
-        m_Nodes.append(parent);
+        nodes.append(parent);
         return;
     } else {
         foreach(DirectedGraphNode *child, parent->childNodes()) {
             if(STATNode *statChild = qgraphicsitem_cast<STATNode *>(child)) {
-                findNodes(statChild);
+                findNodes(statChild, nodes);
             }
         }
     }
@@ -503,7 +695,7 @@ void HideNonBranchingCommand::redo()
     UndoCommand::redo();
 
     if(m_Nodes.isEmpty()) {
-        findNodes();
+        m_Nodes = nonBranchingNodes(qgraphicsitem_cast<STATNode *>(view()->rootNode()));
     }
 
     foreach(STATNode *node, m_Nodes) {
@@ -513,22 +705,30 @@ void HideNonBranchingCommand::redo()
     setFailed(m_Nodes.isEmpty());
 }
 
-bool HideNonBranchingCommand::findNodes(STATNode *parent)
+/*! \fn HideNonBranchingCommand::nonBranchingNodes()
+    \returns Frames below the root that lead to no branches, and that aren't already hidden
+ */
+QList<STATNode *> HideNonBranchingCommand::nonBranchingNodes(STATNode *root)
 {
-    if(!parent) {
-        parent = qgraphicsitem_cast<STATNode *>(view()->rootNode());
+    QList<STATNode *> nodes;
+    if(root) {
+        findNodes(root, nodes);
     }
+    return nodes;
+}
 
+bool HideNonBranchingCommand::findNodes(STATNode *parent, QList<STATNode *> &nodes)
+{
     bool parentBranches = (parent->childNodes().count() > 1);
 
     foreach(DirectedGraphNode *child, parent->childNodes()) {
         if(STATNode *statChild = qgraphicsitem_cast<STATNode *>(child)) {
 
-            bool childBranches = findNodes(statChild);
+            bool childBranches = findNodes(statChild, nodes);
 
             if(!childBranches && parentBranches) {
                 if(!statChild->isCollapsed()) {
-                    m_Nodes.append(statChild);
+                    nodes.append(statChild);
                 }
             }
 
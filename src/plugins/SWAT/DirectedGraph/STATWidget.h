@@ -58,9 +58,11 @@ public:
 
     int id() const { return 4; }
 
+    static QList<STATNode *> mpiNodes(STATNode *root);
+
 protected:
-    void findNodes(STATNode *parent = 0);
-    QStringList mpiFunctions();
+    static void findNodes(STATNode *parent, QList<STATNode *> &nodes);
+    static QStringList mpiFunctions();
 
 private:
     QList<STATNode *> m_Nodes;
@@ -94,8 +96,10 @@ public:
 
     int id() const { return 5; }
 
+    static QList<STATNode *> nonBranchingNodes(STATNode *root);
+
 protected:
-    bool findNodes(STATNode *parent = 0);
+    static bool findNodes(STATNode *parent, QList<STATNode *> &nodes);
 
 private:
     QList<STATNode *> m_Nodes;
@@ -110,15 +114,28 @@ public:
     ~STATWidget();
 
     virtual void setContent(const QByteArray &content);
+    int mergeContent(const QByteArray &content);
+    void refineContent(const QByteArray &detailed, const QStringList &processList);
     virtual DirectedGraphScene *scene() const;
 
 public slots:
     void doHideMPI();
     void doHideNonBranching();
     void doFocus(STATNode *node);
+    void doRefine(STATNode *node);
+    void doSampleTasks(const QStringList &processList);
+    void doDetachTasksStopped(const QStringList &processList);
+
+signals:
+    void refineRequested(const QStringList &processList);
+    void refined(int changed, const QStringList &processList);
+    void sampleTasksRequested(const QStringList &processList);
+    void detachRequested(const QStringList &stopList);
 
 protected:
     virtual DirectedGraphScene *createScene(const QByteArray &content);
+    static QString callPath(STATNode *node);
+    void startRefine();
 
     void openSourceFile(const QString &filename, const int &lineNumber = 0);
     void loadSourceFromFile(const QString &filename, const int &lineNumber = 0);
@@ -127,9 +144,15 @@ protected:
 
 protected slots:
     void selectionChanged();
+    void refineFinished();
 
 private:
     STATScene *m_STATScene;
+    QByteArray m_Content;
+
+    QFutureWatcher<QByteArray> m_RefineWatcher;
+    QStringList m_RefineTasks;
+    QList<QPair<QByteArray, QStringList> > m_RefineQueue;
     QAction *m_HideMPI;
     QAction *m_HideNonBranching;
     QToolBar *m_EditToolBar;
@@ -50,6 +50,84 @@ QGraphVizEdge *SWATScene::createEdge(edge_t *edge)
     return new SWATEdge(edge, this);
 }
 
+//! Quotes a label for DOT content; GraphLib names are raw text
+static QString dotLabel(const QString &label)
+{
+    QString retval = label;
+    retval.replace('\\', "\\\\");
+    retval.replace('"', "\\\"");
+    return retval;
+}
+
+/*! \fn SWATScene::setGraphLib()
+    \brief Fills the scene straight from the node and edge fragments of a loaded GraphLib graph
+    \param graphId Graph created by GraphLibAdapter, with its attributes processed
+
+    The labels are decoded and stored just as those read from DOT content are, without GraphLib exporting the graph
+    to a file and it being scanned again.  Graphviz is still used for layout, and is given only the IDs, the edges
+    and the short labels.
+ */
+void SWATScene::setGraphLib(const QUuid &graphId)
+{
+    GraphLibAdapter &adapter = GraphLibAdapter::instance();
+    const QList<GraphLibNode *> &nodes = adapter.nodes(graphId);
+    const QList<GraphLibEdge *> &edges = adapter.edges(graphId);
+
+    // Lay the labels end to end, so that they're decoded as a single content, concurrently on large graphs
+    QString labels;
+    QVector<Record> records;
+    records.reserve(nodes.count() + edges.count());
+
+    foreach(GraphLibNode *node, nodes) {
+        Record record;
+        record.type = Record_Node;
+        record.id = node->id;
+        record.labelBegin = labels.size();
+        labels.append(node->name);
+        record.labelEnd = labels.size();
+        records.append(record);
+    }
+
+    foreach(GraphLibEdge *edge, edges) {
+        Record record;
+        record.type = Record_Edge;
+        record.id = edge->toId;
+        record.labelBegin = labels.size();
+        labels.append(edge->name);
+        record.labelEnd = labels.size();
+        records.append(record);
+    }
+
+    QVector<Attributes> attributes(records.count());
+    decode(labels, records, attributes);
+
+    QString content;
+    content.reserve(labels.size() + (records.count() * 32));
+    content.append("digraph G {\n\tnode [shape=box,style=filled,fillcolor=white];\n");
+
+    for(int i = 0; i < records.count(); ++i) {
+        const Record &record = records.at(i);
+
+        content.append('\t');
+        if(record.type == Record_Edge) {
+            content.append(QString::number(edges.at(i - nodes.count())->fromId));
+            content.append(" -> ");
+        }
+        content.append(QString::number(record.id));
+
+        QString label = (record.type == Record_Node) ? storeNodeLabel(record.id, attributes.at(i))
+                                                     : storeEdgeLabel(record.id, attributes.at(i));
+
+        content.append(" [label=\"");
+        content.append(dotLabel(label));
+        content.append("\"];\n");
+    }
+
+    content.append("}\n");
+
+    QGraphVizScene::setContent(content);
+}
+
 void SWATScene::processNodeLabel(quint64 id, QString label)
 {
     STATScene::processNodeLabel(id, label);
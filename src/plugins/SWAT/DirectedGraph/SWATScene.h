@@ -39,6 +39,8 @@ class SWATScene : public STATScene
 public:
     explicit SWATScene(QObject *parent = 0);
 
+    void setGraphLib(const QUuid &graphId);
+
 protected:
     enum SwatNodeInfoTypes {
         NodeInfoType_SwatInfo = 7
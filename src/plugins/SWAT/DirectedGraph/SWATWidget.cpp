@@ -45,8 +45,10 @@ SWATWidget::~SWATWidget()
 {
     try {
 
-        GraphLibAdapter adapter = GraphLibAdapter::instance();
-        adapter.deleteGraph(m_GraphId);
+        if(!m_GraphId.isNull()) {
+            GraphLibAdapter &adapter = GraphLibAdapter::instance();
+            adapter.deleteGraph(m_GraphId);
+        }
 
 #ifdef QT_DEBUG
     } catch(QString err) {
@@ -71,7 +73,13 @@ DirectedGraphScene *SWATWidget::createScene(const QByteArray &content)
 {
     if(!m_SWATScene) {
         m_SWATScene = new SWATScene();
-        m_SWATScene->setContent(QString(content));
+
+        // A GraphLib graph is read straight from its fragments, when they could be
+        if(content.isEmpty() && !m_GraphId.isNull()) {
+            m_SWATScene->setGraphLib(m_GraphId);
+        } else {
+            m_SWATScene->setContent(QString(content));
+        }
     }
     return m_SWATScene;
 }
@@ -96,11 +104,14 @@ void SWATWidget::loadGraphLib(const QString filename)
 
     try {
 
-        GraphLibAdapter adapter = GraphLibAdapter::instance();
+        GraphLibAdapter &adapter = GraphLibAdapter::instance();
         m_GraphId = adapter.createGraph(filename);
-        adapter.processAttributes(m_GraphId);
 
-        setContent(adapter.exportDotContent(m_GraphId));
+        if(adapter.isProcessed(m_GraphId)) {
+            setContent(QByteArray());
+        } else {
+            setContent(adapter.exportDotContent(m_GraphId));
+        }
 
 #ifdef QT_DEBUG
     } catch(QString err) {
@@ -0,0 +1,109 @@
+/*!
+   \file StringPool.cpp
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#include "StringPool.h"
+
+namespace Plugins {
+namespace DirectedGraph {
+
+/*! \class StringPool
+    \brief Process wide table of interned strings, shared by every scene
+
+    The same few hundred function names and source files repeat across thousands of frames, and again in every
+    sample that's opened.  Each distinct string is kept once, for the life of the process, and is referred to by an
+    integer handle.  Strings are never removed; the table grows with the number of distinct symbols seen.
+ */
+
+StringPool &StringPool::instance()
+{
+    static StringPool m_Instance;
+    return m_Instance;
+}
+
+StringPool::StringPool()
+{
+    m_Strings.append(QString());
+    m_Handles.insert(QString(), 0);
+}
+
+/*! \fn StringPool::intern()
+    \returns Handle of the string, adding it to the pool if it hasn't been seen before
+ */
+quint32 StringPool::intern(const QString &string)
+{
+    if(string.isEmpty()) {
+        return 0;
+    }
+
+    {
+        QReadLocker locker(&m_Lock);
+        QHash<QString, quint32>::const_iterator iterator = m_Handles.constFind(string);
+        if(iterator != m_Handles.constEnd()) {
+            return iterator.value();
+        }
+    }
+
+    QWriteLocker locker(&m_Lock);
+
+    // Another thread may have added it while the lock was released
+    QHash<QString, quint32>::const_iterator iterator = m_Handles.constFind(string);
+    if(iterator != m_Handles.constEnd()) {
+        return iterator.value();
+    }
+
+    quint32 handle = m_Strings.count();
+    m_Strings.append(string);
+    m_Handles.insert(string, handle);
+    return handle;
+}
+
+/*! \fn StringPool::string()
+    \returns Interned string with the given handle, or an empty string if there's no such handle
+ */
+QString StringPool::string(quint32 handle) const
+{
+    QReadLocker locker(&m_Lock);
+
+    if(handle >= (quint32)m_Strings.count()) {
+        return QString();
+    }
+
+    return m_Strings.at(handle);
+}
+
+/*! \fn StringPool::count()
+    \returns Number of distinct strings in the pool, including the empty string
+ */
+int StringPool::count() const
+{
+    QReadLocker locker(&m_Lock);
+    return m_Strings.count();
+}
+
+} // namespace DirectedGraph
+} // namespace Plugins
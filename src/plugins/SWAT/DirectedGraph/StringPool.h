@@ -0,0 +1,60 @@
+/*!
+   \file StringPool.h
+   \author Dane Gardner <dane.gardner@gmail.com>
+   \version
+
+   \section LICENSE
+   This file is part of the StackWalker Analysis Tool (SWAT)
+   Copyright (C) 2012-2012 Argo Navis Technologies, LLC
+   Copyright (C) 2012-2012 University of Wisconsin
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Lesser General Public License as published by the
+   Free Software Foundation; either version 2.1 of the License, or (at your
+   option) any later version.
+
+   This library is distributed in the hope that it will be useful, but WITHOUT
+   ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License
+   for more details.
+
+   You should have received a copy of the GNU Lesser General Public License
+   along with this library; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+   \section DESCRIPTION
+
+ */
+
+#ifndef PLUGINS_DIRECTEDGRAPH_STRINGPOOL_H
+#define PLUGINS_DIRECTEDGRAPH_STRINGPOOL_H
+
+#include <QtCore>
+
+namespace Plugins {
+namespace DirectedGraph {
+
+class StringPool
+{
+public:
+    static StringPool &instance();
+
+    quint32 intern(const QString &string);
+    QString string(quint32 handle) const;
+    int count() const;
+
+protected:
+    StringPool();
+
+private:
+    mutable QReadWriteLock m_Lock;
+
+    //! Interned strings, indexed by handle; handle 0 is the empty string
+    QVector<QString> m_Strings;
+    QHash<QString, quint32> m_Handles;
+};
+
+} // namespace DirectedGraph
+} // namespace Plugins
+
+#endif // PLUGINS_DIRECTEDGRAPH_STRINGPOOL_H
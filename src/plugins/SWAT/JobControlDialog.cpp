@@ -355,6 +355,12 @@ void JobControlDialog::accept()
 
         sampleOptions->traceFrequency = ui->txtTraceFrequency->value();
 
+        sampleOptions->gatherIndividualSamples = ui->chkGatherIndividualSamples->isChecked();
+
+        sampleOptions->nonStop = ui->chkNonStop->isChecked();
+
+        sampleOptions->perturbationBudget = ui->txtPerturbationBudget->value() / 100.0;
+
         sampleOptions->runTimeBeforeSample = ui->txtRunTime->value();
 
         m_Options = sampleOptions;
@@ -461,6 +467,12 @@ void JobControlDialog::accept()
 
     options->traceFrequency = ui->txtTraceFrequency->value();
 
+    options->gatherIndividualSamples = ui->chkGatherIndividualSamples->isChecked();
+
+    options->nonStop = ui->chkNonStop->isChecked();
+
+    options->perturbationBudget = ui->txtPerturbationBudget->value() / 100.0;
+
     options->runTimeBeforeSample = ui->txtRunTime->value();
 
 
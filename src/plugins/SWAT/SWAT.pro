@@ -37,10 +37,16 @@ SOURCES      += SWATPlugin.cpp \
                 Settings/SettingPage.cpp \
                 Welcome/WelcomeData.cpp \
                 ConnectionManager/IAdapter.cpp \
+                ConnectionManager/PhaseHistory.cpp \
                 JobControlDialog.cpp \
                 ConnectionManager/ConnectionManager.cpp \
                 DirectedGraph/DirectedGraphWidget.cpp \
                 DirectedGraph/DirectedGraphScene.cpp \
+                DirectedGraph/DotPreprocessor.cpp \
+                DirectedGraph/AttributeStore.cpp \
+                DirectedGraph/StringPool.cpp \
+                DirectedGraph/RankList.cpp \
+                DirectedGraph/DotRewriter.cpp \
                 DirectedGraph/DirectedGraphNode.cpp \
                 DirectedGraph/DirectedGraphEdge.cpp \
                 DirectedGraph/STATWidget.cpp \
@@ -62,10 +68,16 @@ HEADERS      += SWATPlugin.h \
                 Welcome/WelcomeData.h \
                 ConnectionManager/ConnectionManagerLibrary.h \
                 ConnectionManager/IAdapter.h \
+                ConnectionManager/PhaseHistory.h \
                 JobControlDialog.h \
                 ConnectionManager/ConnectionManager.h \
                 DirectedGraph/DirectedGraphWidget.h \
                 DirectedGraph/DirectedGraphScene.h \
+                DirectedGraph/DotPreprocessor.h \
+                DirectedGraph/AttributeStore.h \
+                DirectedGraph/StringPool.h \
+                DirectedGraph/RankList.h \
+                DirectedGraph/DotRewriter.h \
                 DirectedGraph/DirectedGraphNode.h \
                 DirectedGraph/DirectedGraphEdge.h \
                 DirectedGraph/STATWidget.h \
@@ -34,8 +34,10 @@
 #include <SettingManager/SettingManager.h>
 #include <PluginManager/PluginManager.h>
 #include <ConnectionManager/ConnectionManager.h>
+#include <ConnectionManager/PhaseHistory.h>
 
 #include <DirectedGraph/STATWidget.h>
+#include <DirectedGraph/RankList.h>
 #include <DirectedGraph/SWATWidget.h>
 #include <SourceView/ISourceViewFactory.h>
 
@@ -51,11 +53,16 @@ SWATMainWidget::SWATMainWidget(QWidget *parent) :
     m_LaunchJob(NULL),
     m_LoadFile(NULL),
     m_CloseJob(NULL),
+    m_ExportTimings(NULL),
     m_ToolBar(NULL),
-    m_CommandsToolBar(NULL)
+    m_CommandsToolBar(NULL),
+    m_WatchTimer(new QTimer(this)),
+    m_PhaseHistory(new PhaseHistory(1000, this))
 {
     ui->setupUi(this);
 
+    connect(m_WatchTimer, SIGNAL(timeout()), this, SLOT(watchTimeout()));
+
     /* Set up the stylesheet for periods when we have tabs */
     m_StyleSheet = styleSheet();
 
@@ -107,6 +114,12 @@ SWATMainWidget::SWATMainWidget(QWidget *parent) :
             m_CloseJob->setProperty("swat_menuitem", QVariant(1));
             connect(m_CloseJob, SIGNAL(triggered()), this, SLOT(closeJob()));
 
+            m_ExportTimings = new QAction(tr("Export Phase Timings"), this);
+            m_ExportTimings->setToolTip(tr("Save the time spent in each phase of the launch, attach and sample operations"));
+            m_ExportTimings->setVisible(false);
+            m_ExportTimings->setProperty("swat_menuitem", QVariant(1));
+            connect(m_ExportTimings, SIGNAL(triggered()), this, SLOT(exportPhaseTimings()));
+
 
             m_ToolBar = new QToolBar(tr("SWAT"), this);
             m_ToolBar->setObjectName("SwatToolBar");
@@ -134,12 +147,14 @@ SWATMainWidget::SWATMainWidget(QWidget *parent) :
                 action->menu()->insertAction(before, m_AttachJob);
                 action->menu()->insertAction(before, m_LoadFile);
                 action->menu()->insertAction(before, m_CloseJob);
+                action->menu()->insertAction(before, m_ExportTimings);
                 action->menu()->insertSeparator(before)->setProperty("swat_menuitem", QVariant(1));
             } else {
                 action->menu()->addAction(m_LaunchJob);
                 action->menu()->addAction(m_AttachJob);
                 action->menu()->addAction(m_LoadFile);
                 action->menu()->addAction(m_CloseJob);
+                action->menu()->addAction(m_ExportTimings);
                 action->menu()->addSeparator()->setProperty("swat_menuitem", QVariant(1));
             }
 
@@ -181,6 +196,13 @@ SWATMainWidget::SWATMainWidget(QWidget *parent) :
             m_SampleMultiple->setEnabled(false);
             connect(m_SampleMultiple, SIGNAL(triggered()), this, SLOT(doSampleMultiple()));
 
+            m_Watch = new QAction(QIcon(":/SWAT/watch.svg"), tr("Watch"), this);
+            m_Watch->setToolTip(tr("Keep sampling the application in the background, updating the current view"));
+            m_Watch->setProperty("swatWidget_menuitem", QVariant(1));
+            m_Watch->setCheckable(true);
+            m_Watch->setEnabled(false);
+            connect(m_Watch, SIGNAL(triggered(bool)), this, SLOT(doWatch(bool)));
+
 
             m_CommandsToolBar = new QToolBar(tr("Process Control"), this);
             m_CommandsToolBar->setObjectName("ProcessControlToolBar");
@@ -191,6 +213,7 @@ SWATMainWidget::SWATMainWidget(QWidget *parent) :
             m_CommandsToolBar->addAction(m_Resume);
             m_CommandsToolBar->addAction(m_Sample);
             m_CommandsToolBar->addAction(m_SampleMultiple);
+            m_CommandsToolBar->addAction(m_Watch);
             mainWindow.addToolBar(Qt::TopToolBarArea, m_CommandsToolBar);
             m_CommandsToolBar->hide();
 
@@ -211,6 +234,7 @@ SWATMainWidget::SWATMainWidget(QWidget *parent) :
                 action->menu()->insertAction(before, m_Resume);
                 action->menu()->insertAction(before, m_Sample);
                 action->menu()->insertAction(before, m_SampleMultiple);
+                action->menu()->insertAction(before, m_Watch);
                 action->menu()->insertSeparator(before)->setProperty("swatWidget_menuitem", QVariant(1));
             } else {
                 action->menu()->insertSeparator(before)->setProperty("swatWidget_menuitem", QVariant(1));
@@ -220,6 +244,7 @@ SWATMainWidget::SWATMainWidget(QWidget *parent) :
                 action->menu()->addAction(m_Resume);
                 action->menu()->addAction(m_Sample);
                 action->menu()->addAction(m_SampleMultiple);
+                action->menu()->addAction(m_Watch);
                 action->menu()->addSeparator()->setProperty("swatWidget_menuitem", QVariant(1));
             }
 
@@ -298,6 +323,8 @@ void SWATMainWidget::setState(const QUuid &id, const StateType &state)
         m_Resume->setEnabled(false);
         m_Sample->setEnabled(false);
         m_SampleMultiple->setEnabled(false);
+        m_Watch->setEnabled(false);
+        m_Watch->setChecked(m_WatchOptions.contains(id));
 
         switch(state) {
           case State_Detached:
@@ -308,12 +335,14 @@ void SWATMainWidget::setState(const QUuid &id, const StateType &state)
             m_Detach->setEnabled(true);
             m_Sample->setEnabled(true);
             m_SampleMultiple->setEnabled(true);
+            m_Watch->setEnabled(true);
             break;
           case State_Running:
             m_Pause->setEnabled(true);
             m_Detach->setEnabled(true);
             m_Sample->setEnabled(true);
             m_SampleMultiple->setEnabled(true);
+            m_Watch->setEnabled(true);
             break;
           case State_Unknown:
             break;
@@ -461,7 +490,10 @@ void SWATMainWidget::CurrentAdapterChanged(IAdapter* from, IAdapter* to)
         connect(to, SIGNAL(launched(QUuid)),                    this, SLOT(attached(QUuid)));
         connect(to, SIGNAL(progress(int,QUuid)),                this, SLOT(progress(int,QUuid)));
         connect(to, SIGNAL(progressMessage(QString,QUuid)),     this, SLOT(progressMessage(QString,QUuid)));
-        connect(to, SIGNAL(sampled(QString,QUuid)),             this, SLOT(sampled(QString,QUuid)));
+        connect(to, SIGNAL(sampledContent(QByteArray,QString,QUuid)), this, SLOT(sampledContent(QByteArray,QString,QUuid)));
+        connect(to, SIGNAL(failed(QString,QUuid)),              this, SLOT(failed(QString,QUuid)));
+        connect(to, SIGNAL(phaseTimed(QString,qint64,QUuid)),   m_PhaseHistory, SLOT(record(QString,qint64,QUuid)),
+                Qt::UniqueConnection);
 
         connect(to, SIGNAL(sampling(QUuid)),                    this, SLOT(sampling(QUuid)));
         connect(to, SIGNAL(detaching(QUuid)),                   this, SLOT(detaching(QUuid)));
@@ -515,6 +547,7 @@ void SWATMainWidget::checkAdapterProgress(IAdapter *adapter)
     disconnect(adapter, SIGNAL(launched(QUuid)),                this, SLOT(attached(QUuid)));
     disconnect(adapter, SIGNAL(progress(int,QUuid)),            this, SLOT(progress(int,QUuid)));
     disconnect(adapter, SIGNAL(progressMessage(QString,QUuid)), this, SLOT(progressMessage(QString,QUuid)));
+    disconnect(adapter, SIGNAL(failed(QString,QUuid)),          this, SLOT(failed(QString,QUuid)));
 
     disconnect(adapter, SIGNAL(sampling(QUuid)),                this, SLOT(sampling(QUuid)));
     disconnect(adapter, SIGNAL(detaching(QUuid)),               this, SLOT(detaching(QUuid)));
@@ -584,6 +617,37 @@ void SWATMainWidget::progressMessage(QString progressMessage, QUuid id)
     }
 }
 
+void SWATMainWidget::failed(QString message, QUuid id)
+{
+    using namespace Core::MainWindow;
+    MainWindow::instance().notify(message, NotificationWidget::Critical);
+
+    if(id.isNull()) {
+        return;
+    }
+
+    // Don't keep a failing sample going in the background
+    if(m_WatchPending.remove(id)) {
+        stopWatching(id);
+    }
+
+    m_RefinePending.remove(id);
+
+    // Operations now complete asynchronously; close any progress dialogs waiting on the failed one
+    for(int i = m_ProgressDialogs.count() - 1; i >= 0; --i) {
+        QProgressDialog *dlg = m_ProgressDialogs.at(i);
+        if(dlg->property("id").toString() != id) {
+            continue;
+        }
+
+        IAdapter *progressAdapter = dlg->property("adapter").value<IAdapter*>();
+
+        m_ProgressDialogs.removeAt(i);
+        dlg->deleteLater();
+        checkAdapterProgress(progressAdapter);
+    }
+}
+
 void SWATMainWidget::cancelAttach()
 {
     QProgressDialog *dlg = qobject_cast<QProgressDialog *>(QObject::sender());
@@ -653,15 +717,64 @@ void SWATMainWidget::hideEvent(QHideEvent *event)
 
 
 
-void SWATMainWidget::sampled(QString filename, QUuid id)
+void SWATMainWidget::refined(int changed, const QStringList &processList)
+{
+    if(QWidget *view = qobject_cast<QWidget *>(sender())) {
+        setTabToolTip(indexOf(view), tr("Refined tasks %1; %n stack frame(s) changed", "", changed)
+                      .arg(processList.join(",")));
+    }
+}
+
+void SWATMainWidget::sampledContent(QByteArray content, QString filename, QUuid id)
 {
     try {
 
-        loadTraceFromFile(filename);
+        // Refining samples are merged into the view they refine
+        if(m_RefinePending.remove(id)) {
+            Plugins::DirectedGraph::STATWidget *view = refineView(id);
+            if(view && !content.isEmpty()) {
+                QStringList processList = view->property("refineTasks").toStringList();
+                view->setProperty("refineTasks", QVariant());
+
+                // The view rewrites the content off the GUI thread, and reports back through refined()
+                view->refineContent(content, processList);
+                return;
+            }
+        }
+
+        // Watched jobs keep updating the same view, instead of opening a tab per sample
+        bool watched = false;
+        if(m_WatchPending.remove(id)) {
+            Plugins::DirectedGraph::STATWidget *view = watchView(id);
+            if(view && !content.isEmpty()) {
+                int changed = view->mergeContent(content);
+                setTabToolTip(indexOf(view), tr("Last sampled at %1; %n stack frame(s) changed", "", changed)
+                              .arg(QTime::currentTime().toString()));
+                return;
+            }
+
+            // The job stopped being watched before its first sample got here
+            if(!m_WatchOptions.contains(id)) {
+                return;
+            }
+
+            watched = true;
+        }
+
+        // The adapter has already read the rendered graph; only go back to the disk if it couldn't
+        if(content.isEmpty()) {
+            loadTraceFromFile(filename);
+        } else {
+            loadTraceFromContent(content, filename);
+        }
 
         // Store the ID for later process control
         this->widget(currentIndex())->setProperty("id", QVariant(id.toString()));
 
+        if(watched) {
+            this->widget(currentIndex())->setProperty("watch", QVariant(true));
+        }
+
     } catch(QString err) {
         using namespace Core::MainWindow;
         MainWindow::instance().notify(tr("Failed to open sample: %1").arg(err), NotificationWidget::Critical);
@@ -689,6 +802,7 @@ void SWATMainWidget::detaching(QUuid id)
         return;
     }
 
+    stopWatching(id);
     setState(id, State_Detached);
 }
 
@@ -716,6 +830,7 @@ void SWATMainWidget::canceling(QUuid id)
         return;
     }
 
+    stopWatching(id);
     setState(id, State_Detached);
 }
 
@@ -752,6 +867,22 @@ void SWATMainWidget::doDetach()
         return;
     }
 
+    Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+    settingManager.beginGroup("Plugins/SWAT");
+    bool keepToolsRunning = settingManager.value("detach/keepToolsRunning", false).toBool();
+    settingManager.endGroup();
+
+    detachJob(QUuid(varId.toString()), keepToolsRunning);
+}
+
+/*! \fn SWATMainWidget::detachJob()
+    \brief Detaches from a job
+    \param id Unique ID of the associated FrontEnd
+    \param keepToolsRunning Leave the daemons and MRNet tree up, so that a reattach takes seconds instead of minutes
+    \param stopList Ranks left stopped, rather than resumed along with the rest of the job
+ */
+void SWATMainWidget::detachJob(const QUuid &id, bool keepToolsRunning, const QList<quint64> &stopList)
+{
     IAdapter *adapter = ConnectionManager::currentAdapter();
     if(!adapter) {
         using namespace Core::MainWindow;
@@ -760,7 +891,16 @@ void SWATMainWidget::doDetach()
     }
 
     try {
-        adapter->detach(QUuid(varId.toString()));
+        IAdapter::DetachOptions options;
+        options.keepToolsRunning = keepToolsRunning;
+        options.stopList = stopList;
+        adapter->detach(id, options);
+
+        if(keepToolsRunning) {
+            m_ToolsRunning.insert(id);
+        } else {
+            m_ToolsRunning.remove(id);
+        }
     } catch(QString err) {
         using namespace Core::MainWindow;
         MainWindow::instance().notify(tr("Error while detaching: %1").arg(err), NotificationWidget::Critical);
@@ -896,6 +1036,314 @@ void SWATMainWidget::doSampleMultiple()
     dialog->deleteLater();
 }
 
+/*! \fn SWATMainWidget::doWatch()
+    \brief Starts or stops watching the job in the current tab
+    \param watch True to start sampling in the background, false to stop
+
+    Watched jobs are sampled non-stop every "watch/interval" milliseconds, and every sample after the first is
+    merged into the same view, so a hang can be watched as it develops.
+ */
+void SWATMainWidget::doWatch(bool watch)
+{
+    QVariant varId = this->currentWidget()->property("id");
+    if(!varId.isValid()) {
+        return;
+    }
+
+    QUuid id(varId.toString());
+
+    if(!watch) {
+        stopWatching(id);
+        return;
+    }
+
+    //Prompt user for the sample preferences used for each watched sample
+    JobControlDialog *dialog = new JobControlDialog(this);
+
+    if(dialog->exec(JobControlDialog::Type_Sample) == QDialog::Accepted &&
+            dialog->options() != NULL) {
+        IAdapter::SampleOptions options = *((IAdapter::SampleOptions*)dialog->options());
+        options.nonStop = true;     // The application is only stopped for as long as each sample takes
+        m_WatchOptions.insert(id, options);
+
+        Core::SettingManager::SettingManager &settingManager = Core::SettingManager::SettingManager::instance();
+        settingManager.beginGroup("Plugins/SWAT");
+        m_WatchTimer->setInterval(settingManager.value("watch/interval", 5000).toInt());
+        settingManager.endGroup();
+
+        if(!m_WatchTimer->isActive()) {
+            m_WatchTimer->start();
+        }
+
+        watchTimeout();
+    } else {
+        m_Watch->setChecked(false);
+    }
+
+    dialog->deleteLater();
+}
+
+/*! \fn SWATMainWidget::watchTimeout()
+    \brief Takes the next background sample of each watched job that isn't still busy with the last one
+ */
+void SWATMainWidget::watchTimeout()
+{
+    IAdapter *adapter = ConnectionManager::currentAdapter();
+    if(!adapter) {
+        return;
+    }
+
+    QList<QUuid> failedIds;
+
+    QHash<QUuid, IAdapter::SampleOptions>::const_iterator i;
+    for(i = m_WatchOptions.constBegin(); i != m_WatchOptions.constEnd(); ++i) {
+        const QUuid &id = i.key();
+
+        // Skip instead of queueing samples behind a slow one
+        if(m_WatchPending.contains(id)) {
+            continue;
+        }
+
+        StateType jobState = state(id);
+        if(jobState != State_Paused && jobState != State_Running) {
+            continue;
+        }
+
+        try {
+            adapter->sample(i.value(), id);
+            m_WatchPending.insert(id);
+        } catch(QString err) {
+            using namespace Core::MainWindow;
+            MainWindow::instance().notify(tr("Error while watching: %1").arg(err), NotificationWidget::Critical);
+            failedIds.append(id);
+        } catch(...) {
+            using namespace Core::MainWindow;
+            MainWindow::instance().notify(tr("Error while watching"), NotificationWidget::Critical);
+            failedIds.append(id);
+        }
+    }
+
+    foreach(QUuid id, failedIds) {
+        stopWatching(id);
+    }
+}
+
+/*! \fn SWATMainWidget::doRefine()
+    \brief Takes a detailed sample of the job behind the sending view, to refine the call paths of some of its tasks
+    \param processList Tasks to refine
+
+    The view is usually a cheap function-only sample.  Once the detailed sample arrives the call paths of the
+    given tasks are replaced by their detailed ones, so that line numbers are only shown where they are wanted.
+ */
+void SWATMainWidget::doRefine(const QStringList &processList)
+{
+    QWidget *view = qobject_cast<QWidget *>(QObject::sender());
+    if(!view) {
+        return;
+    }
+
+    using namespace Core::MainWindow;
+
+    QVariant varId = view->property("id");
+    if(!varId.isValid()) {
+        MainWindow::instance().notify(tr("Only samples of an attached job can be refined"), NotificationWidget::Critical);
+        return;
+    }
+
+    QUuid id(varId.toString());
+
+    // The next sample of the job has to be the refining one
+    if(m_WatchOptions.contains(id) || m_WatchPending.contains(id) || m_RefinePending.contains(id)) {
+        MainWindow::instance().notify(tr("Wait for the job's current sample, or stop watching it, before refining"),
+                                      NotificationWidget::Critical);
+        return;
+    }
+
+    IAdapter *adapter = ConnectionManager::currentAdapter();
+    if(!adapter) {
+        MainWindow::instance().notify(tr("Error while refining: No adapter!"), NotificationWidget::Critical);
+        return;
+    }
+
+    //Prompt user for the detailed sample preferences
+    JobControlDialog *dialog = new JobControlDialog(this);
+
+    if(dialog->exec(JobControlDialog::Type_Sample) == QDialog::Accepted &&
+            dialog->options() != NULL) {
+        IAdapter::SampleOptions options = *((IAdapter::SampleOptions*)dialog->options());
+        if(options.sampleType == IAdapter::Sample_FunctionNameOnly) {
+            options.sampleType = IAdapter::Sample_FunctionAndLine;
+        }
+
+        // Only the refined tasks are merged into the view
+        options.ranks = Plugins::DirectedGraph::RankList::split(processList);
+
+        try {
+            adapter->sample(options, id);
+            view->setProperty("refineTasks", processList);
+            m_RefinePending.insert(id);
+        } catch(QString err) {
+            MainWindow::instance().notify(tr("Error while refining: %1").arg(err), NotificationWidget::Critical);
+        } catch(...) {
+            MainWindow::instance().notify(tr("Error while refining"), NotificationWidget::Critical);
+        }
+    }
+
+    dialog->deleteLater();
+}
+
+/*! \fn SWATMainWidget::doSampleTasks()
+    \brief Takes a sample of the job behind the sending view, restricted to a set of its tasks
+    \param processList Tasks to sample
+
+    The sample is opened in a new tab, holding only the call paths of the given tasks.
+ */
+void SWATMainWidget::doSampleTasks(const QStringList &processList)
+{
+    QWidget *view = qobject_cast<QWidget *>(QObject::sender());
+    if(!view) {
+        return;
+    }
+
+    using namespace Core::MainWindow;
+
+    QVariant varId = view->property("id");
+    if(!varId.isValid()) {
+        MainWindow::instance().notify(tr("Only tasks of an attached job can be sampled"), NotificationWidget::Critical);
+        return;
+    }
+
+    QUuid id(varId.toString());
+
+    // A sample arriving for a watched or refined job would be taken as theirs
+    if(m_WatchOptions.contains(id) || m_WatchPending.contains(id) || m_RefinePending.contains(id)) {
+        MainWindow::instance().notify(tr("Wait for the job's current sample, or stop watching it, before sampling tasks"),
+                                      NotificationWidget::Critical);
+        return;
+    }
+
+    IAdapter *adapter = ConnectionManager::currentAdapter();
+    if(!adapter) {
+        MainWindow::instance().notify(tr("Error while sampling: No adapter!"), NotificationWidget::Critical);
+        return;
+    }
+
+    QList<quint64> ranks = Plugins::DirectedGraph::RankList::split(processList);
+    if(ranks.isEmpty()) {
+        MainWindow::instance().notify(tr("No tasks to sample"), NotificationWidget::Critical);
+        return;
+    }
+
+    //Prompt user for sample preferences
+    JobControlDialog *dialog = new JobControlDialog(this);
+
+    if(dialog->exec(JobControlDialog::Type_Sample) == QDialog::Accepted &&
+            dialog->options() != NULL) {
+        IAdapter::SampleOptions options = *((IAdapter::SampleOptions*)dialog->options());
+        options.ranks = ranks;
+
+        try {
+            adapter->sample(options, id);
+        } catch(QString err) {
+            MainWindow::instance().notify(tr("Error while sampling: %1").arg(err), NotificationWidget::Critical);
+        } catch(...) {
+            MainWindow::instance().notify(tr("Error while sampling"), NotificationWidget::Critical);
+        }
+    }
+
+    dialog->deleteLater();
+}
+
+/*! \fn SWATMainWidget::doDetachTasksStopped()
+    \brief Detaches from the job behind the sending view, leaving a set of its tasks stopped
+    \param processList Tasks to leave stopped
+
+    The rest of the job is resumed and the tools are shut down, so that a debugger can be attached to just the
+    stopped tasks without the job or the tool infrastructure being held up.
+ */
+void SWATMainWidget::doDetachTasksStopped(const QStringList &processList)
+{
+    QWidget *view = qobject_cast<QWidget *>(QObject::sender());
+    if(!view) {
+        return;
+    }
+
+    using namespace Core::MainWindow;
+
+    QVariant varId = view->property("id");
+    if(!varId.isValid()) {
+        MainWindow::instance().notify(tr("Only tasks of an attached job can be left stopped"), NotificationWidget::Critical);
+        return;
+    }
+
+    QUuid id(varId.toString());
+
+    if(state(id) == State_Detached) {
+        MainWindow::instance().notify(tr("Unable to detach; not already attached."), NotificationWidget::Critical);
+        return;
+    }
+
+    QList<quint64> stopList = Plugins::DirectedGraph::RankList::split(processList);
+    if(stopList.isEmpty()) {
+        MainWindow::instance().notify(tr("No tasks to leave stopped"), NotificationWidget::Critical);
+        return;
+    }
+
+    detachJob(id, false, stopList);
+}
+
+/*! \fn SWATMainWidget::refineView()
+    \brief Finds the view waiting for a refining sample of a job
+ */
+Plugins::DirectedGraph::STATWidget *SWATMainWidget::refineView(const QUuid &id)
+{
+    for(int i = 0; i < count(); ++i) {
+        QWidget *widget = this->widget(i);
+        if(widget->property("id").toString() == id && widget->property("refineTasks").isValid()) {
+            if(Plugins::DirectedGraph::STATWidget *view = qobject_cast<Plugins::DirectedGraph::STATWidget *>(widget)) {
+                return view;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*! \fn SWATMainWidget::stopWatching()
+    \brief Stops the background sampling of a job; a sample already under way still updates its view
+ */
+void SWATMainWidget::stopWatching(const QUuid &id)
+{
+    m_WatchOptions.remove(id);
+
+    if(m_WatchOptions.isEmpty()) {
+        m_WatchTimer->stop();
+    }
+
+    QWidget *widget = currentWidget();
+    if(widget && widget->property("id").toString() == id) {
+        m_Watch->setChecked(false);
+    }
+}
+
+/*! \fn SWATMainWidget::watchView()
+    \brief Finds the view that the samples of a watched job are merged into
+    \returns The view, or NULL if the first watched sample hasn't arrived yet or its tab has been closed
+ */
+Plugins::DirectedGraph::STATWidget *SWATMainWidget::watchView(const QUuid &id)
+{
+    for(int i = 0; i < count(); ++i) {
+        QWidget *widget = this->widget(i);
+        if(widget->property("id").toString() == id && widget->property("watch").toBool()) {
+            if(Plugins::DirectedGraph::STATWidget *view = qobject_cast<Plugins::DirectedGraph::STATWidget *>(widget)) {
+                return view;
+            }
+        }
+    }
+
+    return NULL;
+}
+
 
 
 void SWATMainWidget::closeJob(int index)
@@ -912,8 +1360,10 @@ void SWATMainWidget::closeJob(int index)
         QVariant varId = widget->property("id");
         if(varId.isValid()) {
             QUuid id = QUuid(varId.toString());
-            if(state(id) != State_Detached) {
-                doDetach();
+            stopWatching(id);
+            // Make sure any tools kept running for a reattach are shut down along with the job
+            if(state(id) != State_Detached || m_ToolsRunning.contains(id)) {
+                detachJob(id, false);
             }
             m_FrontEndStates.remove(id);
         }
@@ -960,6 +1410,33 @@ void SWATMainWidget::loadTraceFile()
 }
 
 
+void SWATMainWidget::exportPhaseTimings()
+{
+    static QDir path = QDir::currentPath();
+
+    QString filename = QFileDialog::getSaveFileName(this,
+                                                    tr("Export phase timings"),
+                                                    path.absolutePath(),
+                                                    tr("CSV files (*.csv);;JSON files (*.json)")
+                                                    );
+
+    if(filename.isEmpty()) {
+        return;
+    }
+
+    path.setPath(QFileInfo(filename).absolutePath());
+
+    try {
+        m_PhaseHistory->exportToFile(filename);
+    } catch(QString err) {
+        using namespace Core::MainWindow;
+        MainWindow::instance().notify(tr("Failed to export phase timings: %1").arg(err), NotificationWidget::Critical);
+    } catch(...) {
+        using namespace Core::MainWindow;
+        MainWindow::instance().notify(tr("Failed to export phase timings."), NotificationWidget::Critical);
+    }
+}
+
 void SWATMainWidget::loadTraceFromFile(QString filename)
 {
     try {
@@ -982,14 +1459,7 @@ void SWATMainWidget::loadTraceFromFile(QString filename)
             QByteArray fileContent = file.readAll();
             file.close();
 
-            Plugins::DirectedGraph::STATWidget *view = new Plugins::DirectedGraph::STATWidget(this);
-            view->setContent(fileContent);
-
-            view->setWindowFilePath(fileInfo.absoluteFilePath());
-            view->setWindowTitle(fileInfo.completeBaseName());
-
-            int index = addTab(view, view->windowTitle());
-            setCurrentIndex(index);
+            loadTraceFromContent(fileContent, fileInfo.absoluteFilePath());
 
         } else if(fileInfo.suffix().compare("grl") == 0) {
             Plugins::DirectedGraph::SWATWidget *view = new Plugins::DirectedGraph::SWATWidget(this);
@@ -1016,6 +1486,44 @@ void SWATMainWidget::loadTraceFromFile(QString filename)
 
 }
 
+/*! \fn SWATMainWidget::loadTraceFromContent()
+    \brief Opens a new tab with a view of DOT content that is already in memory
+    \param content GraphViz DOT content of the merged stack traces
+    \param filename Path the content was rendered to; only used for the window title and file path
+ */
+void SWATMainWidget::loadTraceFromContent(const QByteArray &content, const QString &filename)
+{
+    try {
+
+        QFileInfo fileInfo(filename);
+
+        using namespace Core::MainWindow;
+        MainWindow &mainWindow = MainWindow::instance();
+        mainWindow.setCurrentCentralWidget(this);
+
+        Plugins::DirectedGraph::STATWidget *view = new Plugins::DirectedGraph::STATWidget(this);
+        view->setContent(content);
+        connect(view, SIGNAL(refineRequested(QStringList)), this, SLOT(doRefine(QStringList)));
+        connect(view, SIGNAL(refined(int,QStringList)), this, SLOT(refined(int,QStringList)));
+        connect(view, SIGNAL(sampleTasksRequested(QStringList)), this, SLOT(doSampleTasks(QStringList)));
+        connect(view, SIGNAL(detachRequested(QStringList)), this, SLOT(doDetachTasksStopped(QStringList)));
+
+        view->setWindowFilePath(fileInfo.absoluteFilePath());
+        view->setWindowTitle(fileInfo.completeBaseName());
+
+        int index = addTab(view, view->windowTitle());
+        setCurrentIndex(index);
+
+    } catch(QString err) {
+        using namespace Core::MainWindow;
+        MainWindow::instance().notify(tr("Failed to create view from content: %1").arg(err), NotificationWidget::Critical);
+    } catch(...) {
+        using namespace Core::MainWindow;
+        MainWindow::instance().notify(tr("Failed to create view from content."), NotificationWidget::Critical);
+    }
+
+}
+
 
 
 } // namespace SWAT
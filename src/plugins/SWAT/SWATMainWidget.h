@@ -34,13 +34,16 @@
 
 #include <PrettyWidgets/TabWidget.h>
 
+#include <ConnectionManager/IAdapter.h>
+
 #include "SWATLibrary.h"
 
+namespace Plugins { namespace DirectedGraph { class STATWidget; } }
+
 namespace Plugins {
 namespace SWAT {
 
-class IAdapter;
-class STATWidget;
+class PhaseHistory;
 
 namespace Ui {
     class SWATMainWidget;
@@ -71,6 +74,10 @@ protected:
     void tabRemoved(int index);
     void checkAdapterProgress(IAdapter *adapter);
     bool searchProcesses();
+    void detachJob(const QUuid &id, bool keepToolsRunning, const QList<quint64> &stopList = QList<quint64>());
+    void stopWatching(const QUuid &id);
+    DirectedGraph::STATWidget *watchView(const QUuid &id);
+    DirectedGraph::STATWidget *refineView(const QUuid &id);
 
     StateType state(const QUuid &id);
     void setState(const QUuid &id, const StateType &state);
@@ -89,9 +96,11 @@ protected slots:
     void launched(QUuid);
     void progress(int, QUuid);
     void progressMessage(QString, QUuid);
+    void failed(QString message, QUuid id);
     void cancelAttach();
 
-    void sampled(QString filename, QUuid id);
+    void sampledContent(QByteArray content, QString filename, QUuid id);
+    void refined(int changed, const QStringList &processList);
 
     void sampling(QUuid id);
     void detaching(QUuid id);
@@ -105,9 +114,16 @@ protected slots:
     void doResume();
     void doSample();
     void doSampleMultiple();
+    void doWatch(bool watch);
+    void watchTimeout();
+    void doRefine(const QStringList &processList);
+    void doSampleTasks(const QStringList &processList);
+    void doDetachTasksStopped(const QStringList &processList);
 
     void loadTraceFile();
+    void exportPhaseTimings();
     void loadTraceFromFile(QString filename);
+    void loadTraceFromContent(const QByteArray &content, const QString &filename);
 
     void closeJob(int index = -1);
 
@@ -120,6 +136,7 @@ private:
     QAction *m_LaunchJob;
     QAction *m_LoadFile;
     QAction *m_CloseJob;
+    QAction *m_ExportTimings;
 
     QAction *m_Reattach;
     QAction *m_Detach;
@@ -127,6 +144,7 @@ private:
     QAction *m_Resume;
     QAction *m_Sample;
     QAction *m_SampleMultiple;
+    QAction *m_Watch;
 
     QToolBar *m_ToolBar;
     QToolBar *m_CommandsToolBar;
@@ -135,6 +153,17 @@ private:
     QList<QProgressDialog*> m_ProgressDialogs;
 
     QHash<QUuid, StateType> m_FrontEndStates;
+    QSet<QUuid> m_ToolsRunning;
+
+    //! Sample options of the jobs being watched, and the jobs with a watch sample still outstanding
+    QHash<QUuid, IAdapter::SampleOptions> m_WatchOptions;
+    QSet<QUuid> m_WatchPending;
+    QTimer *m_WatchTimer;
+
+    //! Jobs with a refining sample outstanding; the view waiting for it holds the tasks to refine
+    QSet<QUuid> m_RefinePending;
+
+    PhaseHistory *m_PhaseHistory;
 
 };
 
@@ -178,6 +178,10 @@ void SettingPage::initialize()
 
     ui->chkDebugBackEnds->setChecked(settingManager.value("logging/debugBackEnd", false).toBool());
 
+    ui->chkKeepToolsRunning->setChecked(settingManager.value("detach/keepToolsRunning", false).toBool());
+
+    ui->txtWatchInterval->setValue(settingManager.value("watch/interval", 5000).toInt());
+
 
     settingManager.endGroup();
 }
@@ -223,6 +227,10 @@ void SettingPage::apply()
     settingManager.setValue("logging/verbosity", ui->cmbVerbosityType->currentText());
     settingManager.setValue("logging/debugBackEnd", ui->chkDebugBackEnds->isChecked());
 
+    settingManager.setValue("detach/keepToolsRunning", ui->chkKeepToolsRunning->isChecked());
+
+    settingManager.setValue("watch/interval", ui->txtWatchInterval->value());
+
 
     settingManager.endGroup();
 }
@@ -17,10 +17,12 @@
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 TEMPLATE                    = subdirs
-SUBDIRS                     = SWAT CompiledAdapter
+SUBDIRS                     = SWAT CompiledAdapter ReplayAdapter
 
 SWAT.subdir                 = SWAT
 
 CompiledAdapter.subdir      = CompiledAdapter
 CompiledAdapter.depends     = SWAT
 
+ReplayAdapter.subdir        = ReplayAdapter
+ReplayAdapter.depends       = SWAT